@@ -29,5 +29,12 @@
     "statusFile": "status.js",
     "taskFolder": "tasks",
     "valveFolder": "valves",
+    "hyperFlushTime": 30,
+    "hyperFlushVolume": 0.5,
+    "preloadTime": 10,
+    "preloadVolume": 0.1,
+    "preloadGroupSize": 4,
+    "preloadPressureLimit": 8,
+    "sessionWindow": 120,
     "valveUpperBound": 23
 }
@@ -1,11 +1,19 @@
 #include <Application/App.hpp>
 
+extern "C" char * sbrk(int incr);
+
+namespace {
+    // Bytes between the top of the heap and the stack
+    int freeRam() {
+        char top;
+        return &top - reinterpret_cast<char *>(sbrk(0));
+    }
+}  // namespace
+
 namespace API {
     auto StartHyperFlush::operator()(App & app) -> R {
-        decltype(auto) hyperFlushName = app.hyperFlushStateController.getCurrentState()->getName();
-
         R response;
-        if (strcmp(HyperFlush::IDLE, hyperFlushName) == 0) {
+        if (app.hyperFlushStateController.isInState(HyperFlush::IDLE)) {
             app.beginHyperFlush();
             response["success"] = "Begin preloading water";
         } else {
@@ -18,7 +26,26 @@ namespace API {
     auto StatusGet::operator()(App & app) -> R {
         R response;
         encodeJSON(app.status, response.to<JsonObject>());
-        response["utc"] = now();
+        response["utc"]                = now();
+        response[StatusKeys::EPOCH]    = app.status.epoch;
+        response[StatusKeys::SEQUENCE] = app.status.sequence;
+        return response;
+    }
+
+    auto StatusDeltaGet::operator()(App & app, JsonDocument & input) -> R {
+        const long epoch          = input["epoch"];
+        const unsigned long since = input["since"];
+        if (!app.status.canEncodeDelta(epoch, since)) {
+            // Client is too far behind (or from before a restart): send a full snapshot
+            return StatusGet{}(app);
+        }
+
+        R response;
+        app.status.encodeDeltaJSON(response.to<JsonObject>(), since);
+        response["utc"]                = now();
+        response[StatusKeys::EPOCH]    = app.status.epoch;
+        response[StatusKeys::SEQUENCE] = app.status.sequence;
+        response[StatusKeys::IS_DELTA] = true;
         return response;
     }
 
@@ -180,4 +207,92 @@ namespace API {
 
         return response;
     }
+
+    auto ValvesGet::operator()(App & app) -> R {
+        R response;
+        encodeJSON(app.vm, response.to<JsonArray>());
+        return response;
+    }
+
+    auto ValvesReset::operator()(App & app) -> R {
+        R response;
+        for (int i = 0; i < app.config.numberOfValves; i++) {
+            app.vm.setValveStatus(i, ValveStatus::Code(app.config.valves[i]));
+        }
+
+        app.vm.writeToDirectory();
+        response["success"] = "Valves reset";
+        return response;
+    }
+
+    auto Stop::operator()(App & app) -> R {
+        R response;
+        app.newStateController.stop();
+        response["success"] = "Stopping";
+        return response;
+    }
+
+    auto LogsGet::operator()(App & app) -> R {
+        R response;
+        JsonArray logs = response.to<JsonArray>();
+
+        // Only the indexed logs have a download route (see App::setupLogRouting)
+        for (const LogIndex * index : {&app.logIndex, &app.detailIndex}) {
+            File file = SD.open(index->log(), FILE_READ);
+            if (!file) {
+                continue;
+            }
+
+            JsonObject log = logs.createNestedObject();
+            log["name"]    = index->log();
+            log["size"]    = file.size();
+            file.close();
+        }
+
+        return response;
+    }
+
+    auto MetricsGet::operator()(App & app) -> R {
+        R response;
+
+        const BootTimeline & boot = app.bootTimeline;
+        JsonObject bootObject     = response.createNestedObject("boot");
+        bootObject["total"]       = boot.total();
+        bootObject["cost"]        = boot.cost();
+        JsonArray phases          = bootObject.createNestedArray("phases");
+        for (size_t i = 0; i < boot.size(); i++) {
+            JsonObject phase  = phases.createNestedObject();
+            phase["name"]     = boot[i].name;
+            phase["start"]    = boot.startOf(i);
+            phase["duration"] = boot.durationOf(i);
+        }
+
+        const IdleStatistics & idle = app.idle.statistics;
+        JsonObject idleObject       = response.createNestedObject("idle");
+        idleObject["sleeps"]        = idle.sleeps;
+        idleObject["totalSleep"]    = idle.totalSleep;
+        idleObject["earlyWakes"]    = idle.earlyWakes;
+        idleObject["uptime"]        = millis();
+        idleObject["current"]       = idle.averageCurrent(millis());
+        idleObject["activeCurrent"] = ProgramSettings::MCU_ACTIVE_CURRENT_MA;
+
+        JsonObject timersObject = response.createNestedObject("timers");
+        copyArray(app.timers.latency.histogram, timersObject.createNestedArray("latency"));
+
+        response["freeRam"] = freeRam();
+        return response;
+    }
+
+    auto WiFiStart::operator()(App & app) -> R {
+        R response;
+        if (app.wifi.isStarted()) {
+            response["success"] = "WiFi is already on";
+        } else {
+            // Brings the radio up on a unit that booted without it
+            app.wifi.start();
+            response["success"] = "WiFi on";
+        }
+
+        return response;
+    }
 }  // namespace API
\ No newline at end of file
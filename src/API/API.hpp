@@ -4,6 +4,7 @@
 #include <ArduinoJson.h>
 #include <tuple>
 #include <Application/Status.hpp>
+#include <Valve/ValveManager.hpp>
 
 template <typename Signature>
 struct APISpec;
@@ -30,6 +31,10 @@ namespace API {
         auto operator()(Arg<0>) -> R;
     };
 
+    struct StatusDeltaGet : APISpec<JsonResponse<Status::encodingSize()>(App &, JsonDocument &)> {
+        auto operator()(Arg<0>, Arg<1>) -> R;
+    };
+
     struct ConfigGet : APISpec<JsonResponse<Config::encodingSize()>(App &)> {
         auto operator()(Arg<0>) -> R;
     };
@@ -62,4 +67,28 @@ namespace API {
     struct RTCUpdate : APISpec<JsonResponse<100>(App &, JsonDocument &)> {
         auto operator()(Arg<0>, Arg<1>) -> R;
     };
+
+    struct ValvesGet : APISpec<JsonResponse<ValveManager::encodingSize()>(App &)> {
+        auto operator()(Arg<0>) -> R;
+    };
+
+    struct ValvesReset : APISpec<JsonResponse<100>(App &)> {
+        auto operator()(Arg<0>) -> R;
+    };
+
+    struct Stop : APISpec<JsonResponse<100>(App &)> {
+        auto operator()(Arg<0>) -> R;
+    };
+
+    struct LogsGet : APISpec<JsonResponse<ProgramSettings::LOG_LIST_BUFFER_SIZE>(App &)> {
+        auto operator()(Arg<0>) -> R;
+    };
+
+    struct MetricsGet : APISpec<JsonResponse<ProgramSettings::METRICS_JSON_BUFFER_SIZE>(App &)> {
+        auto operator()(Arg<0>) -> R;
+    };
+
+    struct WiFiStart : APISpec<JsonResponse<100>(App &)> {
+        auto operator()(Arg<0>) -> R;
+    };
 };  // namespace API
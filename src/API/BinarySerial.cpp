@@ -0,0 +1,234 @@
+#include <Application/App.hpp>
+#include <API/BinarySerial.hpp>
+
+namespace {
+    uint32_t readU32(const uint8_t * bytes) {
+        return uint32_t(bytes[0]) | uint32_t(bytes[1]) << 8 | uint32_t(bytes[2]) << 16
+               | uint32_t(bytes[3]) << 24;
+    }
+
+    void writeU32(uint8_t * bytes, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            bytes[i] = value >> (8 * i);
+        }
+    }
+
+    // Splits a JSON response into COMMAND_DATA frames
+    class FramePrinter : public Print, public API::Responder {
+    private:
+        BinarySerial & serial;
+        uint16_t seq;
+        uint8_t buffer[BinarySerial::MAX_PAYLOAD];
+        size_t length = 0;
+
+    public:
+        FramePrinter(BinarySerial & serial, uint16_t seq) : serial(serial), seq(seq) {}
+
+        size_t write(uint8_t c) override {
+            buffer[length++] = c;
+            if (length == sizeof(buffer)) {
+                sendBuffer();
+            }
+
+            return 1;
+        }
+
+        void sendBuffer() {
+            if (length) {
+                serial.sendFrame(BinarySerial::COMMAND_DATA, seq, buffer, length);
+                length = 0;
+            }
+        }
+
+        void send(const JsonDocument & response) override {
+            serializeJson(response, *this);
+            sendBuffer();
+        }
+    };
+}  // namespace
+
+void BinarySerial::begin() {
+    active        = true;
+    rxLength      = 0;
+    rxOverflow    = false;
+    lastFrameTime = millis();
+    sendFrame(PONG, 0, nullptr, 0);
+}
+
+void BinarySerial::end() {
+    if (file) {
+        file.close();
+    }
+
+    fileRemaining = 0;
+    active        = false;
+}
+
+void BinarySerial::update() {
+    if (!active) {
+        return;
+    }
+
+    while (Serial.available()) {
+        const int c = Serial.read();
+        if (c != 0) {
+            if (rxLength < sizeof(rx)) {
+                rx[rxLength++] = c;
+            } else {
+                rxOverflow = true;
+            }
+
+            continue;
+        }
+
+        // Frame delimiter
+        if (!rxOverflow && rxLength) {
+            const size_t length = Framing::cobsDecode(rx, rxLength, rx);
+            frameReceived(rx, length);
+        }
+
+        rxLength   = 0;
+        rxOverflow = false;
+        if (!active) {
+            return;
+        }
+    }
+
+    if (fileRemaining) {
+        continueFileRead();
+    } else if (millis() - lastFrameTime > idleTimeout) {
+        println("Binary serial: idle timeout");
+        end();
+    }
+}
+
+void BinarySerial::frameReceived(uint8_t * frame, size_t length) {
+    // Minimum: type + seq + crc. Frames with a bad checksum are dropped silently. The
+    // host retries on timeout.
+    if (length < 5) {
+        return;
+    }
+
+    const uint16_t crc = frame[length - 2] | frame[length - 1] << 8;
+    if (Framing::crc16(frame, length - 2) != crc) {
+        return;
+    }
+
+    lastFrameTime          = millis();
+    const uint8_t type     = frame[0];
+    const uint16_t seq     = frame[1] | frame[2] << 8;
+    uint8_t * payload      = frame + 3;
+    const size_t available = length - 5;
+    payload[available]     = 0;  // Overwrites the crc so strings are terminated
+
+    switch (type) {
+    case PING:
+        sendFrame(PONG, seq, nullptr, 0);
+        break;
+    case FILE_INFO: {
+        File info = SD.open(reinterpret_cast<char *>(payload), FILE_READ);
+        if (!info) {
+            sendError(seq, "File not found");
+            break;
+        }
+
+        uint8_t size[4];
+        writeU32(size, info.size());
+        info.close();
+        sendFrame(FILE_SIZE, seq, size, sizeof(size));
+    } break;
+    case FILE_READ: {
+        if (available < 9) {
+            sendError(seq, "Invalid request");
+            break;
+        }
+
+        if (file) {
+            file.close();
+        }
+
+        file = SD.open(reinterpret_cast<char *>(payload + 8), FILE_READ);
+        if (!file) {
+            sendError(seq, "File not found");
+            break;
+        }
+
+        fileSeq       = seq;
+        fileOffset    = std::min<uint32_t>(readU32(payload), file.size());
+        fileRemaining = std::min<uint32_t>(readU32(payload + 4), file.size() - fileOffset);
+        file.seek(fileOffset);
+        continueFileRead();
+    } break;
+    case COMMAND: {
+        API::RouteInput input;
+        deserializeJson(input, reinterpret_cast<const char *>(payload));
+
+        const API::Route * route = API::findRoute(input["cmd"]);
+        if (!route) {
+            sendError(seq, "Unknown command");
+            break;
+        }
+
+        FramePrinter printer(*this, seq);
+        route->handler(app, input, printer);
+        sendFrame(COMMAND_END, seq, nullptr, 0);
+    } break;
+    case EXIT:
+        sendFrame(EXIT_ACK, seq, nullptr, 0);
+        end();
+        break;
+    default:
+        sendError(seq, "Unknown frame type");
+    }
+}
+
+void BinarySerial::continueFileRead() {
+    uint8_t payload[MAX_PAYLOAD];
+    for (int i = 0; i < framesPerUpdate && fileRemaining; i++) {
+        const size_t chunk = std::min<uint32_t>(fileRemaining, MAX_PAYLOAD - 4);
+        const int read     = file.read(payload + 4, chunk);
+        if (read <= 0) {
+            fileRemaining = 0;
+            break;
+        }
+
+        writeU32(payload, fileOffset);
+        sendFrame(FILE_DATA, fileSeq, payload, read + 4);
+        fileOffset += read;
+        fileRemaining -= read;
+    }
+
+    if (fileRemaining == 0) {
+        file.close();
+        writeU32(payload, fileOffset);
+        sendFrame(FILE_END, fileSeq, payload, 4);
+    }
+
+    lastFrameTime = millis();
+}
+
+void BinarySerial::sendError(uint16_t seq, const char * message) {
+    sendFrame(ERROR, seq, reinterpret_cast<const uint8_t *>(message), strlen(message));
+}
+
+void BinarySerial::sendFrame(Type type, uint16_t seq, const uint8_t * payload, size_t length) {
+    uint8_t frame[MAX_FRAME];
+    frame[0] = type;
+    frame[1] = seq & 0xFF;
+    frame[2] = seq >> 8;
+    if (length) {
+        memcpy(frame + 3, payload, length);
+    }
+
+    const uint16_t crc = Framing::crc16(frame, length + 3);
+    frame[length + 3]  = crc & 0xFF;
+    frame[length + 4]  = crc >> 8;
+
+    // Leading zero ends whatever text was printed since the last frame so that the host
+    // drops that text on its own instead of together with this frame
+    uint8_t encoded[Framing::encodedSize(MAX_FRAME) + 2];
+    encoded[0]               = 0;
+    size_t encodedLength     = 1 + Framing::cobsEncode(frame, length + 5, encoded + 1);
+    encoded[encodedLength++] = 0;
+    Serial.write(encoded, encodedLength);
+}
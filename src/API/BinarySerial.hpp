@@ -0,0 +1,87 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <SD.h>
+
+#include <Utilities/Framing.hpp>
+
+class App;
+
+//
+// ────────────────────────────────────────────────────────────────── I ──────────
+//   :::::: B I N A R Y   S E R I A L : :  :   :    :     :        :          :
+// ────────────────────────────────────────────────────────────────────────────
+//
+// Framed binary mode of the serial interface for bulk transfers. Entered with the
+// {"cmd": "binary"} text command. Every frame is COBS encoded and enclosed in zeros:
+//
+//     [type: u8][seq: u16][payload: 0..MAX_PAYLOAD][crc16: u16]    (little endian)
+//
+// Text printed while binary mode is active lands between two zeros and fails the checksum
+// on the host, so it never corrupts a frame.
+//
+// Replies echo the seq of the request. File data frames carry their absolute file offset
+// so that the host can verify continuity and resume an interrupted download by asking
+// for the remaining range. See tools/sampler_serial.py for the host side.
+//
+// This component must be added before KPSerialInput so that it consumes the incoming
+// bytes while binary mode is active.
+//
+class BinarySerial : public KPComponent {
+public:
+    enum Type : uint8_t {
+        PING      = 0x01,  // -> PONG
+        FILE_INFO = 0x02,  // filename -> FILE_SIZE (u32 size)
+        FILE_READ = 0x03,  // u32 offset, u32 length, filename -> FILE_DATA..., FILE_END
+        COMMAND   = 0x04,  // JSON API command -> COMMAND_DATA..., COMMAND_END
+        EXIT      = 0x0F,  // -> EXIT_ACK, back to text mode
+
+        PONG         = 0x81,
+        FILE_SIZE    = 0x82,
+        FILE_DATA    = 0x83,  // u32 offset, data
+        FILE_END     = 0x84,  // u32 offset after the last byte sent
+        COMMAND_DATA = 0x85,  // Chunk of the JSON response
+        COMMAND_END  = 0x86,
+        EXIT_ACK     = 0x8F,
+        ERROR        = 0xEE,  // Text message
+    };
+
+    static constexpr size_t MAX_PAYLOAD = 256;
+    static constexpr size_t MAX_FRAME   = MAX_PAYLOAD + 5;
+
+    // Leave binary mode automatically if the host goes quiet
+    unsigned long idleTimeout = 30000;
+
+    // Number of data frames sent per update() so the rest of the loop keeps running
+    int framesPerUpdate = 8;
+
+    BinarySerial(const char * name, App & app) : KPComponent(name), app(app) {}
+
+    void begin();
+    void end();
+    void update() override;
+
+    bool isActive() const {
+        return active;
+    }
+
+    void sendFrame(Type type, uint16_t seq, const uint8_t * payload, size_t length);
+
+private:
+    App & app;
+    bool active = false;
+
+    uint8_t rx[Framing::encodedSize(MAX_FRAME)];
+    size_t rxLength             = 0;
+    bool rxOverflow             = false;
+    unsigned long lastFrameTime = 0;
+
+    // Ongoing FILE_READ
+    File file;
+    uint16_t fileSeq       = 0;
+    uint32_t fileOffset    = 0;
+    uint32_t fileRemaining = 0;
+
+    void frameReceived(uint8_t * frame, size_t length);
+    void sendError(uint16_t seq, const char * message);
+    void continueFileRead();
+};
@@ -0,0 +1,170 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <KPStateMachine.hpp>
+#include <WiFi101.h>
+#include <ArduinoJson.h>
+
+#include <Application/Constants.hpp>
+#include <Application/Status.hpp>
+#include <Valve/ValveObserver.hpp>
+#include <Components/SensorArrayObserver.hpp>
+
+//
+// ────────────────────────────────────────────────────────────────── I ──────────
+//   :::::: E V E N T   S T R E A M : :  :   :    :     :        :          :
+// ────────────────────────────────────────────────────────────────────────────
+//
+// Server-sent events for /api/events. Observer callbacks only mark fields as pending;
+// update() then writes the pending fields of Status to the connected client as one
+// compact JSON event, at most once per minInterval.
+//
+class EventStream : public KPComponent,
+                    public KPStateMachineObserver,
+                    public ValveObserver,
+                    public SensorArrayObserver {
+private:
+    enum Field : uint8_t {
+        STATE    = 1 << 0,
+        PRESSURE = 1 << 1,
+        FLOW     = 1 << 2,
+        VALVES   = 1 << 3,
+        ALL      = 0xFF,
+    };
+
+    const Status & status;
+    WiFiClient client;
+    bool connected = false;
+
+    uint8_t pendingFields       = 0;
+    uint32_t pendingValves      = 0;  // One bit per valve id
+    unsigned long lastEventTime = 0;
+
+public:
+    unsigned long minInterval       = 500;
+    unsigned long heartbeatInterval = 15000;
+
+    EventStream(const char * name, const Status & status) : KPComponent(name), status(status) {}
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Start streaming events to the client. Only one client is served at a
+     *  time. The previous one, if any, is disconnected.
+     *
+     *  @param newClient Client of the /api/events request with headers already sent
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void attach(WiFiClient & newClient) {
+        if (connected) {
+            client.stop();
+        }
+
+        client        = newClient;
+        connected     = true;
+        pendingFields = ALL;
+        pendingValves = 0xFFFFFFFF;
+        lastEventTime = 0;
+    }
+
+    bool isConnected() const {
+        return connected;
+    }
+
+    void update() override {
+        if (!connected) {
+            return;
+        }
+
+        if (!client.connected()) {
+            client.stop();
+            connected = false;
+            return;
+        }
+
+        const auto elapsed = millis() - lastEventTime;
+        if (pendingFields && elapsed >= minInterval) {
+            sendEvent();
+        } else if (elapsed >= heartbeatInterval) {
+            // Comment line keeps proxies from closing the connection and lets us notice
+            // a client that went away
+            client.print(":\n\n");
+            lastEventTime = millis();
+        }
+    }
+
+private:
+    void sendEvent() {
+        using namespace StatusKeys;
+        StaticJsonDocument<384> doc;
+        doc[EPOCH]    = status.epoch;
+        doc[SEQUENCE] = status.sequence;
+
+        if (pendingFields & STATE) {
+            doc[CURRENT_STATE] = status.currentStateName;
+        }
+
+        if (pendingFields & PRESSURE) {
+            doc[SENSOR_PRESSURE] = status.pressure;
+            doc[SENSOR_TEMP]     = status.temperature;
+        }
+
+        if (pendingFields & FLOW) {
+            doc[SENSOR_FLOW]   = status.waterFlow;
+            doc[SENSOR_VOLUME] = status.waterVolume;
+        }
+
+        if (pendingFields & VALVES) {
+            JsonObject valves = doc.createNestedObject(StatusKeys::VALVES);
+            for (size_t i = 0; i < status.valves.size() && i < 32; i++) {
+                if (pendingValves & (1UL << i)) {
+                    char key[4];
+                    itoa(i, key, 10);
+                    valves[key] = status.valves[i];
+                }
+            }
+        }
+
+        // One socket write per event instead of one per character
+        char frame[448];
+        size_t length = strlen(strcpy(frame, "data: "));
+        length += serializeJson(doc, frame + length, sizeof(frame) - length - 2);
+        frame[length++] = '\n';
+        frame[length++] = '\n';
+        client.write(reinterpret_cast<const uint8_t *>(frame), length);
+
+        pendingFields = 0;
+        pendingValves = 0;
+        lastEventTime = millis();
+    }
+
+    const char * KPStateMachineObserverName() const override {
+        return "EventStream-KPStateMachine Observer";
+    }
+
+    const char * ValveObserverName() const override {
+        return "EventStream-Valve Observer";
+    }
+
+    const char * SensorManagerObserverName() const override {
+        return "EventStream-SensorArray Observer";
+    }
+
+    void stateDidBegin(const KPState * current) override {
+        pendingFields |= STATE;
+    }
+
+    void valveDidUpdate(const Valve & valve) override {
+        pendingFields |= VALVES;
+        pendingValves |= 1UL << valve.id;
+    }
+
+    void valveArrayDidUpdate(const std::vector<Valve> & valves) override {
+        pendingFields |= VALVES;
+        pendingValves = 0xFFFFFFFF;
+    }
+
+    void flowSensorDidUpdate(TurbineFlowSensor::SensorData & values) override {
+        pendingFields |= FLOW;
+    }
+
+    void pressureSensorDidUpdate(PressureSensor::SensorData & values) override {
+        pendingFields |= PRESSURE;
+    }
+};
@@ -0,0 +1,93 @@
+#include <Application/App.hpp>
+#include <API/Router.hpp>
+
+namespace API {
+    namespace {
+        template <typename T>
+        typename T::R call(App & app, JsonDocument &, std::integral_constant<size_t, 1>) {
+            return T{}(app);
+        }
+
+        template <typename T>
+        typename T::R call(App & app, JsonDocument & input, std::integral_constant<size_t, 2>) {
+            return T{}(app, input);
+        }
+
+        /** ────────────────────────────────────────────────────────────────────────────
+         *  @brief Route handler for API functor T. The response document lives on the
+         *  stack of this function only; nothing is allocated on the heap.
+         *
+         *  ──────────────────────────────────────────────────────────────────────────── */
+        template <typename T>
+        void invoke(App & app, JsonDocument & input, Responder & responder) {
+            using Arity         = std::tuple_size<typename T::ArgsTuple>;
+            const auto response = call<T>(app, input, Arity{});
+            responder.send(response);
+        }
+
+        constexpr int compare(const char * lhs, const char * rhs) {
+            return (*lhs != *rhs || *lhs == 0) ? *lhs - *rhs : compare(lhs + 1, rhs + 1);
+        }
+
+        template <size_t N>
+        constexpr bool isSortedByName(const Route (&table)[N]) {
+            for (size_t i = 1; i < N; i++) {
+                if (compare(table[i - 1].name, table[i].name) >= 0) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // clang-format off
+        constexpr Route table[] = {
+            {"config",          "/api/config",          Method::get,  invoke<ConfigGet>},
+            {"logs",            "/api/logs",            Method::get,  invoke<LogsGet>},
+            {"metrics",         "/api/metrics",         Method::get,  invoke<MetricsGet>},
+            {"preload",         "/api/preload",         Method::get,  invoke<StartHyperFlush>},
+            {"rtc/update",      "/api/rtc/update",      Method::post, invoke<RTCUpdate>},
+            {"status",          nullptr,                Method::get,  invoke<StatusGet>},
+            {"status/delta",    nullptr,                Method::get,  invoke<StatusDeltaGet>},
+            {"stop",            "/stop",                Method::get,  invoke<Stop>},
+            {"task/create",     "/api/task/create",     Method::post, invoke<TaskCreate>},
+            {"task/delete",     "/api/task/delete",     Method::post, invoke<TaskDelete>},
+            {"task/get",        "/api/task/get",        Method::post, invoke<TaskGet>},
+            {"task/save",       "/api/task/save",       Method::post, invoke<TaskSave>},
+            {"task/schedule",   "/api/task/schedule",   Method::post, invoke<TaskSchedule>},
+            {"task/unschedule", "/api/task/unschedule", Method::post, invoke<TaskUnschedule>},
+            {"valves",          "/api/valves",          Method::get,  invoke<ValvesGet>},
+            {"valves/reset",    "/api/valves/reset",    Method::get,  invoke<ValvesReset>},
+            {"wifi",            nullptr,                Method::get,  invoke<WiFiStart>},
+        };
+        // clang-format on
+
+        static_assert(isSortedByName(table), "API routes must be sorted by name with no duplicate");
+    }  // namespace
+
+    const Route * const routes  = table;
+    const size_t numberOfRoutes = sizeof(table) / sizeof(Route);
+
+    const Route * findRoute(const char * name) {
+        if (!name) {
+            return nullptr;
+        }
+
+        size_t low = 0, high = numberOfRoutes;
+        while (low < high) {
+            const size_t mid = (low + high) / 2;
+            const int order  = strcmp(name, table[mid].name);
+            if (order == 0) {
+                return &table[mid];
+            }
+
+            if (order < 0) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+
+        return nullptr;
+    }
+}  // namespace API
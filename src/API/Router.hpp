@@ -0,0 +1,51 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <ArduinoJson.h>
+
+#include <Application/Constants.hpp>
+
+class App;
+namespace API {
+    //
+    // ────────────────────────────────────────────────────────── I ──────────
+    //   :::::: R O U T E R : :  :   :    :     :        :          :
+    // ────────────────────────────────────────────────────────────────────
+    //
+    // Transport-agnostic table of every API. Serial and HTTP adapters look up the route
+    // by name (or register it by path) and provide a Responder that knows how to write
+    // the JSON response to their transport.
+    //
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Interface implemented by each transport to deliver the response
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    class Responder {
+    public:
+        virtual void send(const JsonDocument & response) = 0;
+    };
+
+    // Large enough for the biggest request body (a full task object)
+    using RouteInput   = StaticJsonDocument<ProgramSettings::TASK_JSON_BUFFER_SIZE>;
+    using RouteHandler = void (*)(App &, JsonDocument &, Responder &);
+
+    enum class Method { get, post };
+
+    struct Route {
+        const char * name;      // Serial command (ex: "task/get")
+        const char * httpPath;  // nullptr if not exposed over HTTP
+        Method method;
+        RouteHandler handler;
+    };
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Find route by name using binary search over the sorted route table
+     *
+     *  @param name Route name
+     *  @return const Route* nullptr if there is no such route
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    const Route * findRoute(const char * name);
+
+    extern const Route * const routes;
+    extern const size_t numberOfRoutes;
+}  // namespace API
@@ -2,90 +2,50 @@
 #include <Components/Sensors/FlowSensor.hpp>
 
 namespace {
-    struct SerialRequest {
-        const char * cmd;
-        const JsonArray & path;
-        const JsonDocument & input;
-    };
-
-    using FunctionType = std::function<void(SerialRequest req)>;
-    using StringToFunc = std::unordered_map<std::string, FunctionType>;
-    StringToFunc mapNameToCallback;
-
     constexpr const char EOT = '\4';
 
     void endTransmission() {
         print(EOT);
     }
-}  // namespace
 
-// Registering Top-level serial commands
-void App::setupSerialRouting() {
-    mapNameToCallback["hyperflush"] = [this](SerialRequest req) {
-        const auto response = dispatchAPI<API::StartHyperFlush>();
-        serializeJson(response, Serial);
-    };
-
-    mapNameToCallback["query"] = [this](SerialRequest req) {
-        const char * endpoint = req.path[1];
-        if (strcmp(endpoint, "status") == 0) {
-            const auto & response = dispatchAPI<API::StatusGet>();
+    class SerialResponder : public API::Responder {
+    public:
+        void send(const JsonDocument & response) override {
             serializeJson(response, Serial);
             endTransmission();
-            return;
-        }
-
-        if (strcmp(endpoint, "config") == 0) {
-            const auto & response = dispatchAPI<API::ConfigGet>();
-            serializeJson(response, Serial);
-            endTransmission();
-            return;
-        }
-
-        if (strcmp(endpoint, "ram") == 0) {
-            printFreeRam();
-            endTransmission();
-            return;
-        }
-    };
-
-    mapNameToCallback["reset"] = [this](SerialRequest req) {
-        const char * endpoint = req.path[1];
-        if (strcmp(endpoint, "valves") == 0) {
-            for (int i = 0; i < config.numberOfValves; i++) {
-                vm.setValveStatus(i, ValveStatus::Code(config.valves[i]));
-            }
-
-            vm.writeToDirectory();
-
-            StaticJsonDocument<ValveManager::encodingSize()> response;
-            encodeJSON(vm, response.to<JsonVariant>());
-            serializeJson(response, Serial);
-            endTransmission();
-            return;
         }
     };
-}
+}  // namespace
 
 /**
+ * Commands are dispatched through the shared API route table (see API/Router.hpp)
  *
  * {
- * 	path: ["top-level command", "sub1", "sub2"],
- * cmd: ""
- * 	...
+ * 	cmd: "task/get",
+ * 	...arguments of the API
  * }
  */
 
 void App::commandReceived(const char * msg, size_t size) {
+    // Text replies would only get in the way of the frames
+    if (binarySerial.isActive()) {
+        return;
+    }
+
     if (msg[0] == '{') {
-        StaticJsonDocument<512> input;
+        loadDeferred();  // Commands may need any valve or task
+
+        API::RouteInput input;
         deserializeJson(input, msg);
 
-        for (auto & item : mapNameToCallback) {
-            if (item.first == input["cmd"].as<const char *>()) {
-                item.second({input["cmd"], input["path"], input});
-                break;
-            }
+        const char * cmd = input["cmd"];
+        if (const API::Route * route = API::findRoute(cmd)) {
+            SerialResponder responder;
+            route->handler(*this, input, responder);
+        } else if (cmd && strcmp(cmd, "binary") == 0) {
+            // Switch to framed binary mode for bulk transfers. See API/BinarySerial.hpp
+            binarySerial.begin();
+            return;
         }
     }
 
@@ -1,165 +1,418 @@
 #include <Application/App.hpp>
+#include <Utilities/ResponsePrinter.hpp>
 
-void App::setupServerRouting() {
-    server.handlers.reserve(13);
+namespace {
+    // Serialized body of the last /api/status response. It is rebuilt only when the
+    // status sequence number moves.
+    struct StatusCache {
+        char body[ProgramSettings::STATUS_BODY_BUFFER_SIZE]{0};
+        char length[10]{0};
+        unsigned long sequence = 0;
+    } statusCache;
 
-    server.get("/", [this](Request & req, Response & res) {
-        if (strstr(req.header, "br")) {
-            res.setHeader("Content-Encoding", "br");
-            res.sendFile("index.br", fileLoader);
-        } else {
-            res.setHeader("Content-Encoding", "gzip");
-            res.sendFile("index.gz", fileLoader);
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Check if the given header line of the request contains the value
+     *
+     *  @param headers Raw request headers
+     *  @param name Header name including the colon (ex: "If-None-Match:")
+     *  @param value Value to look for
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    bool headerContains(const char * headers, const char * name, const char * value) {
+        const char * line = strstr(headers, name);
+        if (!line) {
+            return false;
         }
-        res.end();
-    });
 
-    server.get("/api/preload", [this](Request &, Response & res) {
-        const auto & response = dispatchAPI<API::StartHyperFlush>();
-        res.json(response);
-        res.end();
-    });
+        const char * match = strstr(line + strlen(name), value);
+        const char * end   = strstr(line, "\r\n");
+        return match && (!end || match < end);
+    }
 
-    // ────────────────────────────────────────────────────────────────────────────────
-    // Get the current status
-    // ────────────────────────────────────────────────────────────────────────────────
-    server.get("/api/status", [this](Request &, Response & res) {
-        const auto & response = dispatchAPI<API::StatusGet>();
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Copy the value of a query string parameter (ex: /api/status?epoch=7&since=12)
+     *
+     *  @param target Request path including the query string
+     *  @param key Parameter name
+     *  @param value Output buffer
+     *  @param size Size of the output buffer
+     *  @return bool true if the parameter is present
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    bool queryValue(const char * target, const char * key, char * value, size_t size) {
+        const char * query     = strchr(target, '?');
+        const size_t keyLength = strlen(key);
+        while (query) {
+            query++;
+            if (strncmp(query, key, keyLength) == 0 && query[keyLength] == '=') {
+                const char * start  = query + keyLength + 1;
+                const size_t length = std::min(strcspn(start, "& "), size - 1);
+                strncpy(value, start, length);
+                value[length] = 0;
+                return true;
+            }
 
-        KPStringBuilder<10> length(measureJson(response));
-        res.setHeader("Content-Length", length);
-        res.json(response);
-        res.end();
+            query = strchr(query, '&');
+        }
 
-        serializeJsonPretty(response, Serial);
-    });
+        return false;
+    }
 
-    // ────────────────────────────────────────────────────────────────────────────────
-    // Get a list of valve objects
-    // ────────────────────────────────────────────────────────────────────────────────
-    server.get("/api/valves", [this](Request &, Response & res) {
-        StaticJsonDocument<ValveManager::encodingSize()> response;
-        encodeJSON(vm, response.to<JsonArray>());
+    // Route paths of the log files. The server keeps pointers to these.
+    char logRoutePaths[2][10 + ProgramSettings::SD_FILE_NAME_LENGTH];
 
-        KPStringBuilder<10> length(measureJson(response));
-        res.setHeader("Content-Length", length);
-        res.json(response);
-        res.end();
-    });
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Offset of the first row in the log with a utc greater than the given one.
+     *  The index brings us to within a few rows of it and the rest is a linear scan.
+     *  Rows start with their utc so the header line reads as utc 0.
+     *
+     *  @return uint32_t Size of the file if there is no such row
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    uint32_t firstRowAfter(File & file, const LogIndex & index, uint32_t utc) {
+        uint32_t position = index.offsetAtOrBefore(utc);
+        file.seek(position);
 
-    // ────────────────────────────────────────────────────────────────────────────────
-    // Get a list of task objects
-    // ────────────────────────────────────────────────────────────────────────────────
-    server.get("/api/tasks", [this](Request &, Response & res) {
-        StaticJsonDocument<TaskManager::encodingSize()> response;
-        encodeJSON(tm, response.to<JsonArray>());
+        while (position < file.size()) {
+            uint32_t rowUtc = 0;
+            uint32_t length = 0;
+            int c;
+            while ((c = file.read()) >= '0' && c <= '9') {
+                rowUtc = rowUtc * 10 + (c - '0');
+                length++;
+            }
+
+            if (rowUtc > utc) {
+                return position;
+            }
 
-        KPStringBuilder<10> length(measureJson(response));
+            for (length++; c >= 0 && c != '\n'; length++) {
+                c = file.read();
+            }
+
+            position += length;
+        }
+
+        return file.size();
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Parse the Range header (ex: "bytes=0-499", "bytes=500-", "bytes=-500")
+     *
+     *  @param headers Raw request headers
+     *  @param size Size of the selected content
+     *  @param first Output: first byte of the range
+     *  @param last Output: last byte of the range (inclusive)
+     *  @return int 0 if there is no (supported) Range header, 206 if the range is valid
+     *  and 416 if it is not satisfiable
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    int parseRange(const char * headers, uint32_t size, uint32_t & first, uint32_t & last) {
+        const char * range = strstr(headers, "Range: bytes=");
+        if (!range) {
+            return 0;
+        }
+
+        char * end;
+        range += strlen("Range: bytes=");
+        if (*range == '-') {
+            // Suffix range: the last n bytes
+            const uint32_t suffix = strtoul(range + 1, &end, 10);
+            if (end == range + 1 || suffix == 0 || size == 0) {
+                return 416;
+            }
+
+            first = size - std::min(suffix, size);
+            last  = size - 1;
+            return 206;
+        }
+
+        first = strtoul(range, &end, 10);
+        if (end == range || *end != '-' || first >= size) {
+            return 416;
+        }
+
+        range = end + 1;
+        last  = strtoul(range, &end, 10);
+        if (end == range || last >= size) {
+            last = size - 1;
+        }
+
+        return last < first ? 416 : 206;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Call back with each [begin, end) byte range of the log that falls between
+     *  start and end and matches the filter
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    template <typename Callback>
+    void forEachSelectedRange(
+        const LogIndex & index, const LogIndexFilter & filter, uint32_t start, uint32_t end,
+        Callback && callback) {
+        if (filter.isEmpty()) {
+            callback(start, end);
+            return;
+        }
+
+        index.forEachRange(filter, [&](uint32_t begin, uint32_t finish) {
+            begin  = std::max(begin, start);
+            finish = std::min(finish, end);
+            if (begin < finish) {
+                callback(begin, finish);
+            }
+        });
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Send a log file. The optional query parameters select rows: from and to
+     *  by utc (inclusive), task by task id and valve by valve number. A Range header
+     *  then applies to the selected rows so an interrupted download can be resumed with
+     *  the same query.
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void sendLogFile(const LogIndex & index, Request & req, Response & res) {
+        SD.begin(HardwarePins::SD_CARD);
+        File file = SD.open(index.log(), FILE_READ);
+        if (!file) {
+            res.setStatus(404);
+            res.end();
+            return;
+        }
+
+        char value[12];
+        uint32_t start = 0;
+        uint32_t end   = file.size();
+        if (queryValue(req.path, "from", value, sizeof(value))) {
+            const uint32_t from = strtoul(value, nullptr, 10);
+            start               = from ? firstRowAfter(file, index, from - 1) : 0;
+        }
+
+        if (queryValue(req.path, "to", value, sizeof(value))) {
+            end = firstRowAfter(file, index, strtoul(value, nullptr, 10));
+        }
+
+        LogIndexFilter filter;
+        if (queryValue(req.path, "task", value, sizeof(value))) {
+            filter.taskId = atoi(value);
+        }
+
+        if (queryValue(req.path, "valve", value, sizeof(value))) {
+            filter.valve = atoi(value);
+        }
+
+        uint32_t size = 0;
+        forEachSelectedRange(index, filter, start, end, [&](uint32_t begin, uint32_t finish) {
+            size += finish - begin;
+        });
+
+        // Requested bytes [first, last] of the selection
+        uint32_t first = 0, last = size - 1;
+        const int rangeStatus = parseRange(req.header, size, first, last);
+        if (rangeStatus == 416) {
+            KPStringBuilder<32> contentRange("bytes */", size);
+            res.setStatus(416);
+            res.setHeader("Content-Range", contentRange);
+            res.end();
+            file.close();
+            return;
+        }
+
+        if (rangeStatus == 206) {
+            KPStringBuilder<48> contentRange("bytes ", first, "-", last, "/", size);
+            res.setStatus(206);
+            res.setHeader("Content-Range", contentRange);
+        }
+
+        KPStringBuilder<10> length(size ? last - first + 1 : 0);
+        res.setHeader("Content-Type", "text/csv");
         res.setHeader("Content-Length", length);
-        res.json(response);
-        res.end();
-    });
+        res.setHeader("Accept-Ranges", "bytes");
 
-    // ────────────────────────────────────────────────────────────────────────────────
-    // Get task with name
-    // ────────────────────────────────────────────────────────────────────────────────
-    server.post("/api/task/get", [this](Request & req, Response & res) {
-        StaticJsonDocument<Task::encodingSize()> body;
-        deserializeJson(body, req.body);
-        serializeJsonPretty(body, Serial);
+        // Logs are plain text so the data can go through the text interface of the response
+        char buffer[129];
+        uint32_t position = 0;  // Within the selection
+        forEachSelectedRange(index, filter, start, end, [&](uint32_t begin, uint32_t finish) {
+            const uint32_t rangeSize = finish - begin;
+            if (size == 0 || position > last || position + rangeSize <= first) {
+                position += rangeSize;
+                return;
+            }
 
-        const auto & response = dispatchAPI<API::TaskGet>(body);
-        res.json(response);
-        res.end();
-    });
+            const uint32_t skip = first > position ? first - position : 0;
+            uint32_t remaining  = std::min(rangeSize, last + 1 - position) - skip;
+            file.seek(begin + skip);
+            position += rangeSize;
 
-    // ────────────────────────────────────────────────────────────────────────────────
-    // Create a new task with name
-    // ────────────────────────────────────────────────────────────────────────────────
-    server.post("/api/task/create", [this](Request & req, Response & res) {
-        StaticJsonDocument<100> body;
-        deserializeJson(body, req.body);
-        serializeJsonPretty(body, Serial);
-
-        const auto & response = dispatchAPI<API::TaskCreate>(body);
-        res.json(response);
-        serializeJsonPretty(response, Serial);
-        res.end();
-    });
+            while (remaining) {
+                const size_t chunk = std::min<uint32_t>(remaining, sizeof(buffer) - 1);
+                const int read     = file.read(buffer, chunk);
+                if (read <= 0) {
+                    break;
+                }
 
-    // ────────────────────────────────────────────────────────────────────────────────
-    // Update existing task with incoming data
-    // ────────────────────────────────────────────────────────────────────────────────
-    server.post("/api/task/save", [this](Request & req, Response & res) {
-        StaticJsonDocument<Task::encodingSize()> body;
-        deserializeJson(body, req.body);
-        serializeJsonPretty(body, Serial);
+                buffer[read] = 0;
+                res.send(buffer);
+                remaining -= read;
+            }
+        });
 
-        const auto & response = dispatchAPI<API::TaskSave>(body);
-        res.json(response);
+        file.close();
         res.end();
-    });
+    }
 
-    // ────────────────────────────────────────────────────────────────────────────────
-    // Schedule a task (marking it active)
-    // ────────────────────────────────────────────────────────────────────────────────
-    server.post("/api/task/schedule", [this](Request & req, Response & res) {
-        StaticJsonDocument<100> body;
-        deserializeJson(body, req.body);
-        serializeJsonPretty(body, Serial);
+    class HttpResponder : public API::Responder {
+    private:
+        Response & res;
+
+    public:
+        explicit HttpResponder(Response & res) : res(res) {}
+
+        void send(const JsonDocument & response) override {
+            KPStringBuilder<10> length(measureJson(response));
+            res.setHeader("Content-Length", length);
+            res.json(response);
+        }
+    };
+}  // namespace
+
+void App::setupServerRouting() {
+    server.handlers.reserve(6 + API::numberOfRoutes);
 
-        const auto & response = dispatchAPI<API::TaskSchedule>(body);
-        res.json(response);
+    wifi.get("/", [this](Request & req, Response & res) {
+        if (strstr(req.header, "br")) {
+            res.setHeader("Content-Encoding", "br");
+            res.sendFile("index.br", fileLoader);
+        } else {
+            res.setHeader("Content-Encoding", "gzip");
+            res.sendFile("index.gz", fileLoader);
+        }
         res.end();
     });
 
     // ────────────────────────────────────────────────────────────────────────────────
-    // Unschedule a task (making it inactive)
+    // Get the current status
     // ────────────────────────────────────────────────────────────────────────────────
-    server.post("/api/task/unschedule", [this](Request & req, Response & res) {
-        StaticJsonDocument<100> body;
-        deserializeJson(body, req.body);
-        serializeJsonPretty(body, Serial);
+    // The web app polls this endpoint. Responses are tagged with the status sequence
+    // number so that unchanged polls cost a header comparison instead of a full encode.
+    wifi.get("/api/status", [this](Request & req, Response & res) {
+        KPStringBuilder<32> etag("\"", status.epoch, "-", status.sequence, "\"");
+        res.setHeader("ETag", etag);
+        res.setHeader("Cache-Control", "no-cache");
+
+        if (headerContains(req.header, "If-None-Match:", etag)) {
+            res.setStatus(304);
+            res.end();
+            return;
+        }
+
+        // Delta request: only what changed since the sequence number the client last saw.
+        // Without the epoch of that sequence number the client gets a full snapshot.
+        char since[12];
+        char epoch[12] = {0};
+        if (queryValue(req.path, "since", since, sizeof(since))) {
+            queryValue(req.path, "epoch", epoch, sizeof(epoch));
+            StaticJsonDocument<64> input;
+            input["epoch"]        = strtol(epoch, nullptr, 10);
+            input["since"]        = strtoul(since, nullptr, 10);
+            const auto & response = dispatchAPI<API::StatusDeltaGet>(input);
+            KPStringBuilder<10> length(measureJson(response));
+            res.setHeader("Content-Length", length);
+            res.json(response);
+            res.end();
+            return;
+        }
+
+        if (statusCache.sequence != status.sequence) {
+            const auto & response = dispatchAPI<API::StatusGet>();
+            const size_t length   = measureJson(response);
+            if (length >= sizeof(statusCache.body)) {
+                // Too large to cache. Should not happen unless the status grows.
+                KPStringBuilder<10> contentLength(length);
+                res.setHeader("Content-Length", contentLength);
+                res.json(response);
+                res.end();
+                return;
+            }
 
-        const auto & response = dispatchAPI<API::TaskUnschedule>(body);
-        res.json(response);
+            serializeJson(response, statusCache.body, sizeof(statusCache.body));
+            snprintf(statusCache.length, sizeof(statusCache.length), "%u", length);
+            statusCache.sequence = status.sequence;
+        }
+
+        res.setHeader("Content-Type", "application/json");
+        res.setHeader("Content-Length", statusCache.length);
+        res.send(statusCache.body);
         res.end();
     });
 
     // ────────────────────────────────────────────────────────────────────────────────
-    // Delete task with name
+    // Stream status changes as server-sent events over a single connection
     // ────────────────────────────────────────────────────────────────────────────────
-    server.post("/api/task/delete", [this](Request & req, Response & res) {
-        StaticJsonDocument<100> body;
-        deserializeJson(body, req.body);
+    wifi.get("/api/events", [this](Request &, Response & res) {
+        res.setHeader("Content-Type", "text/event-stream");
+        res.setHeader("Cache-Control", "no-cache");
+        res.send("retry: 2000\n\n");
 
-        const auto & response = dispatchAPI<API::TaskDelete>(body);
-        res.json(response);
-        res.end();
+        // res.end() is not called on purpose. The connection is handed over to the event
+        // stream which keeps it open until the client disconnects.
+        events.attach(res.client);
     });
 
     // ────────────────────────────────────────────────────────────────────────────────
-    // RTC update
+    // Get a list of task objects
     // ────────────────────────────────────────────────────────────────────────────────
-    server.post("/api/rtc/update", [this](Request & req, Response & res) {
-        StaticJsonDocument<100> body;
-        deserializeJson(body, req.body);
+    wifi.get("/api/tasks", [this](Request &, Response & res) {
+        // Tasks are encoded one by one into the same document and streamed to the client,
+        // so the response size is not limited by the amount of memory we can spare
+        StaticJsonDocument<Task::encodingSize()> scratch;
 
-        const auto & response = dispatchAPI<API::RTCUpdate>(body);
-        res.json(response);
+        KPStringBuilder<10> length(tm.measureJsonArray(scratch));
+        res.setHeader("Content-Type", "application/json");
+        res.setHeader("Content-Length", length);
+
+        ResponsePrinter<64> printer(res);
+        tm.printJsonArray(printer, scratch);
+        printer.sendBuffer();
         res.end();
     });
 
     // ────────────────────────────────────────────────────────────────────────────────
-    // Emergency stop
+    // Everything else comes from the shared API route table
     // ────────────────────────────────────────────────────────────────────────────────
-    server.get("/stop", [this](Request & req, Response & res) { newStateController.stop(); });
+    for (size_t i = 0; i < API::numberOfRoutes; i++) {
+        const API::Route & route = API::routes[i];
+        if (!route.httpPath) {
+            continue;
+        }
 
-    server.get("/api/valves/reset", [this](Request & req, Response & res) {
-        for (int i = 0; i < config.numberOfValves; i++) {
-            vm.setValveStatus(i, ValveStatus::Code(config.valves[i]));
+        auto handler = [this, &route](Request & req, Response & res) {
+            API::RouteInput input;
+            if (route.method == API::Method::post) {
+                deserializeJson(input, req.body);
+            }
+
+            HttpResponder responder(res);
+            route.handler(*this, input, responder);
+            res.end();
+        };
+
+        if (route.method == API::Method::post) {
+            wifi.post(route.httpPath, handler);
+        } else {
+            wifi.get(route.httpPath, handler);
         }
-        vm.writeToDirectory();
-        res.end();
-    });
-}
\ No newline at end of file
+    }
+}
+
+// ────────────────────────────────────────────────────────────────────────────────
+// Download log files: /api/logs/<name>[?from=<utc>&to=<utc>&task=<id>&valve=<number>].
+// The list of log files is available at /api/logs. Needs the config for the name of the
+// sample log.
+// ────────────────────────────────────────────────────────────────────────────────
+void App::setupLogRouting() {
+    LogIndex * indices[] = {&logIndex, &detailIndex};
+    for (size_t i = 0; i < 2; i++) {
+        LogIndex & index = *indices[i];
+        snprintf(logRoutePaths[i], sizeof(logRoutePaths[i]), "/api/logs/%s", index.log());
+        wifi.get(logRoutePaths[i], [this, &index](Request & req, Response & res) {
+            sendLogFile(index, req, res);
+        });
+    }
+}
@@ -10,12 +10,21 @@
 #include <Application/Constants.hpp>
 #include <Application/Status.hpp>
 #include <Application/ScheduleReturnCode.hpp>
+#include <Application/SampleStatistics.hpp>
+#include <Application/ResumeRecord.hpp>
 
 #include <Components/Pump.hpp>
 #include <Components/ShiftRegister.hpp>
 #include <Components/Power.hpp>
 #include <Components/SensorArray.hpp>
 #include <Components/Intake.hpp>
+#include <Components/SampleTrace.hpp>
+#include <Components/PressureRegulator.hpp>
+#include <Components/Sequencer.hpp>
+#include <Components/SensorCondition.hpp>
+#include <Components/TimerWheel.hpp>
+#include <Components/IdleSleep.hpp>
+#include <Components/WiFiControl.hpp>
 
 #include <StateControllers/NewStateController.hpp>
 #include <StateControllers/HyperFlushStateController.hpp>
@@ -27,21 +36,27 @@
 #include <Task/TaskManager.hpp>
 
 #include <Utilities/JsonEncodableDecodable.hpp>
+#include <Utilities/LogIndex.hpp>
+#include <Utilities/BootTimeline.hpp>
 
 #include <API/API.hpp>
+#include <API/Router.hpp>
+#include <API/BinarySerial.hpp>
+#include <API/EventStream.hpp>
 
 #include <configuration.hpp>
 
 class App : public KPController, public KPSerialInputObserver, public TaskObserver {
 private:
-    void setupAPI();
-    void setupSerialRouting();
     void setupServerRouting();
+    void setupLogRouting();
     void commandReceived(const char * line, size_t size) override;
 
 public:
     KPFileLoader fileLoader{"file-loader", HardwarePins::SD_CARD};
     KPServer server{"web-server", SERVER_NAME, SERVER_PASSWORD};
+    WiFiControl wifi{"wifi", server};
+    BinarySerial binarySerial{"binary-serial", *this};
 
     Pump pump{
         "pump",
@@ -60,8 +75,12 @@ public:
 
     Power power{"power"};
     BallIntake intake{shift};
+    Sequencer sequencer{"sequencer"};
+    TimerWheel timers{"timers"};
+    IdleSleep idle;
     Config config{ProgramSettings::CONFIG_FILE_PATH};
     Status status;
+    EventStream events{"event-stream", status};
 
     // MainStateController sm;
     NewStateController newStateController;
@@ -71,10 +90,37 @@ public:
     TaskManager tm;
 
     SensorArray sensors{"sensor-array"};
+    SampleTrace trace{"sample-trace", sensors, pump};
+    SampleStatistics sampleStatistics;
+    PressureRegulator pressureRegulator{pump};
+    SensorCondition sensorCondition;
+
+    // Sparse time indices of the sample log and the detail log for /api/logs/<name>
+    LogIndex logIndex;
+    LogIndex detailIndex;
+
+    BootTimeline bootTimeline;
 
     int currentTaskId = 0;
 
+    // Deadline of the current time-limited state (see SharedStates)
+    TimerWheel::Handle stateDeadline;
+
 private:
+    bool shuttingDown = false;
+    TimerWheel::Handle taskExecution;
+
+    // Milliseconds of setup() without the serial monitor wait. Cost side of sleepOrShutdown().
+    unsigned long bootDuration = 0;
+
+    // Wake up time of the last standby logged by sleepOrShutdown()
+    time_t standbyWakeTime = 0;
+
+    // Fast resume: only the task of the resume record and the valves in loadedValves are
+    // in memory until loadDeferred()
+    bool deferredLoad     = false;
+    uint32_t loadedValves = 0;
+
     const char * KPSerialInputObserverName() const override {
         return "Application-KPSerialInput Observer";
     }
@@ -87,9 +133,11 @@ public:
     void setup() override {
         KPSerialInput::sharedInstance().addObserver(this);
         Serial.begin(115200);
+        bootTimeline.mark("serial");
 
 #ifdef DEBUG
         while (!Serial) {};
+        bootTimeline.mark("serial monitor", true);
         println();
         println(BLUE("=================================================="));
         println(BLUE("                   DEBUG MODE"));
@@ -102,29 +150,62 @@ public:
         // Here we add and initialize the power module first.
         // So we can seed the random number generator with actual time from RTC.
         addComponent(power);
+        addComponent(timers);
         randomSeed(now());
+        status.epoch = random(1, RAND_MAX);
+        bootTimeline.mark("power");
+
+        //
+        // ─── FAST RESUME ─────────────────────────────────────────────────
+        //
+        // Woken up by the alarm: the RTC SRAM says what the wake up is for. With the next
+        // task due, only that task and its valves are loaded below. With nothing due yet
+        // (ex: a long wait chained in steps of RTC_ALARM_MAX_DELAY), re-arm and cut the
+        // power again without touching the SD card. Any other power on takes the full boot.
+        ResumeRecord record;
+        const bool resuming =
+            !status.isProgrammingMode() && power.wokeByAlarm && record.read(power.rtc);
+        if (resuming && !record.isDue(now())) {
+            return rearmFromRecord(record);
+        }
+
+        ResumeRecord::invalidate(power.rtc);
 
         //
         // ─── ADD WIFI SERVER ─────────────────────────────────────────────
         //
 
-        addComponent(server);
-        server.begin();
+        // Routes are ready for whenever the radio comes up. Scheduled wakes leave it off.
+        addComponent(wifi);
         setupServerRouting();
+        if (status.isProgrammingMode()) {
+            wifi.start();
+        }
+
+        bootTimeline.mark("server");
 
         //
         // ─── ADDING COMPONENTS ───────────────────────────────────────────
         //
 
+        // Binary serial must come first so it can take over the incoming bytes when active
+        addComponent(binarySerial);
         addComponent(KPSerialInput::sharedInstance());
-        setupSerialRouting();
 
         addComponent(ActionScheduler::sharedInstance());
         addComponent(fileLoader);
         addComponent(shift);
         addComponent(pump);
+        addComponent(sequencer);
         addComponent(sensors);
         sensors.addObserver(status);
+        sensors.addObserver(events);
+        sensors.addObserver(trace);
+        sensors.addObserver(sampleStatistics);
+        sensors.addObserver(pressureRegulator);
+        sensors.addObserver(sensorCondition);
+        addComponent(trace);
+        bootTimeline.mark("components");
 
         //
         // ─── LOADING CONFIG FILE ─────────────────────────────────────────
@@ -133,6 +214,7 @@ public:
         JsonFileLoader loader;
         loader.load(config.configFilepath, config);
         status.init(config);
+        bootTimeline.mark("config");
 
         //
         // ─── ADDING VALVE MANAGER ────────────────────────────────────────
@@ -140,7 +222,7 @@ public:
 
         vm.init(config);
         vm.addObserver(status);
-        vm.loadValvesFromDirectory(config.valveFolder);
+        vm.addObserver(events);
 
         //
         // ─── ADDING TASK MANAGER ─────────────────────────────────────────
@@ -148,15 +230,27 @@ public:
 
         tm.init(config);
         tm.addObserver(this);
-        tm.loadTasksFromDirectory(config.taskFolder);
+
+        // The rest of the valves and tasks of a fast resume wait for loadDeferred()
+        if (!resuming || !loadFromRecord(record)) {
+            vm.loadValvesFromDirectory(config.valveFolder);
+            bootTimeline.mark("valves");
+            tm.loadTasksFromDirectory(config.taskFolder);
+        }
+
+        bootTimeline.mark("tasks");
 
         //
         // ─── HYPER FLUSH CONTROLLER ──────────────────────────────────────
         //
 
-        hyperFlushStateController.configure([](HyperFlush::Config & config) {
-            config.flushTime   = 5;
-            config.preloadTime = 5;
+        hyperFlushStateController.configure([this](HyperFlush::Config & hyperFlush) {
+            hyperFlush.flushTime            = config.hyperFlushTime;
+            hyperFlush.flushVolume          = config.hyperFlushVolume;
+            hyperFlush.preloadTime          = config.preloadTime;
+            hyperFlush.preloadVolume        = config.preloadVolume;
+            hyperFlush.preloadGroupSize     = config.preloadGroupSize;
+            hyperFlush.preloadPressureLimit = config.preloadPressureLimit;
         });
 
         addComponent(hyperFlushStateController);
@@ -168,58 +262,90 @@ public:
 
         addComponent(newStateController);
         newStateController.addObserver(status);
+        newStateController.addObserver(events);
         newStateController.idle();  // Wait in IDLE
 
-        // Print WiFi status
-        if (server.enabled()) {
-            println();
-            println(BLUE("====================== WIFI ======================"));
-            server.printWiFiStatus();
-            println(BLUE("=================================================="));
-        }
-
-        // Regular log header
-        if (!SD.exists(config.logFile)) {
-            File file = SD.open(config.logFile, FILE_WRITE);
-            KPStringBuilder<384> header{"UTC, Formatted Time, Task Name, Valve Number, Current "
-                                        "State, Config Sample Time, Config Sample "
-                                        "Pressure, Config Sample Volume, Temperature Recorded,"
-                                        "Max Pressure Recorded, Volume Recorded\n"};
-            file.println(header);
-            file.close();
-        }
-
-        // Detail log header
-        if (!SD.exists("detail.csv")) {
-            File file = SD.open("detail.csv", FILE_WRITE);
-            KPStringBuilder<384> header{"UTC, Formatted Time, Task Name, Valve Number, Current "
-                                        "State, Config Sample Time, Config Sample "
-                                        "Pressure, Config Sample Volume, Temperature Recorded,"
-                                        "Pressure Recorded, Volume Recorded\n"};
-            file.println(header);
-            file.close();
-        }
-
-        // RTC Interrupt callback
-        power.onInterrupt([this]() {
-            println(GREEN("RTC Interrupted!"));
+        // The task from the record could not be started (ex: missed), so the next one has
+        // to be found among all of them
+        if (deferredLoad && currentTaskId == 0) {
+            loadDeferred();
             println(scheduleNextActiveTask().description());
+        }
+
+        addComponent(events);
+        bootTimeline.mark("controllers");
+
+        //
+        // ─── LOG FILES ───────────────────────────────────────────────────
+        //
+
+        // Headers come first since a log with an outdated header is moved away, which
+        // leaves its index stale
+        prepareLog(
+            config.logFile,
+            "UTC, Formatted Time, Task Name, Valve Number, Current State, Config Sample Time, "
+            "Config Sample Pressure, Config Sample Volume, Temperature Recorded,Max Pressure "
+            "Recorded, Volume Recorded, Stop Condition, Duration, Pressure Mean, Pressure Min, "
+            "Pressure Max, Pressure Variance, Flow Mean, Flow Min, Flow Max, Flow Variance, Time "
+            "To Pressure, Integrated Volume\n");
+        prepareLog(
+            ProgramSettings::DETAIL_LOG_FILE,
+            "UTC, Formatted Time, Task Name, Valve Number, Current State, Config Sample Time, "
+            "Config Sample Pressure, Config Sample Volume, Temperature Recorded,Pressure "
+            "Recorded, Volume Recorded\n");
+        bootTimeline.mark("log headers");
+
+        logIndex.init(config.logFile, 1);
+        detailIndex.init(
+            ProgramSettings::DETAIL_LOG_FILE, ProgramSettings::DETAIL_LOG_INDEX_INTERVAL);
+        for (LogIndex * index : {&logIndex, &detailIndex}) {
+            if (index->needsRebuild()) {
+                loadDeferred();  // Task names of the whole log
+                index->rebuild([this](const char * name) { return tm.findTaskIdByName(name); });
+            }
+        }
+
+        setupLogRouting();
+        bootTimeline.mark("log indices");
+
+
+        // RTC Interrupt callback. Quiet during binary transfers to keep the link clean.
+        power.onInterrupt([this]() {
+            const ScheduleReturnCode code = scheduleNextActiveTask();
+            if (!binarySerial.isActive()) {
+                println(GREEN("RTC Interrupted!"));
+                println(code.description());
+            }
         });
 
-        runForever(1000, "detailLog", [&]() { logDetail("detail.csv"); });
+        status.updateBatteryStatus();
+        timers.schedule(10000, [this]() { status.updateBatteryStatus(); }, 10000);
+        timers.schedule(1000, [this]() { logDetail(); }, 1000);
 #ifdef DEBUG
-        runForever(2000, "memLog", [&]() { printFreeRam(); });
+        timers.schedule(
+            2000,
+            [this]() {
+                if (!binarySerial.isActive()) {
+                    printFreeRam();
+                }
+            },
+            2000);
 #endif
+
+        bootTimeline.mark("finish");
+        bootDuration = bootTimeline.cost() / 1000;
+        bootTimeline.appendToFile(ProgramSettings::BOOT_LOG_FILE, now());
     }
 
-    void logDetail(const char * filename) {
+    void logDetail() {
         if (currentTaskId) {
             SD.begin(HardwarePins::SD_CARD);
-            File log    = SD.open(filename, FILE_WRITE);
+            File log    = SD.open(detailIndex.log(), FILE_WRITE);
             Task & task = tm.tasks.at(currentTaskId);
 
             char formattedTime[64];
             auto utc = now();
+            detailIndex.rowWillAppend(utc, log.size(), currentTaskId, status.currentValve);
             sprintf(
                 formattedTime, "%u/%u/%u %02u:%02u:%02u GMT+0", year(utc), month(utc), day(utc),
                 hour(utc), minute(utc), second(utc));
@@ -259,6 +385,7 @@ public:
 
         char formattedTime[64];
         auto utc = now();
+        logIndex.rowWillAppend(utc, log.size(), currentTaskId, status.currentValve);
         sprintf(
             formattedTime, "%u/%u/%u %02u:%02u:%02u GMT+0", year(utc), month(utc), day(utc),
             hour(utc), minute(utc), second(utc));
@@ -285,9 +412,40 @@ public:
             status.maxPressure,
             ",",
             status.waterVolume};
-        log.println(data);
+
+        const SampleSummary & sample = sampleStatistics.summary;
+        KPStringBuilder<256> statistics{
+            ",",
+            sample.condition,
+            ",",
+            sample.duration,
+            ",",
+            sample.pressureMean,
+            ",",
+            sample.pressureMin,
+            ",",
+            sample.pressureMax,
+            ",",
+            sample.pressureVariance,
+            ",",
+            sample.flowMean,
+            ",",
+            sample.flowMin,
+            ",",
+            sample.flowMax,
+            ",",
+            sample.flowVariance,
+            ",",
+            sample.timeToPressure,
+            ",",
+            sample.volume};
+        log.print(data);
+        log.println(statistics);
         log.flush();
         log.close();
+
+        // High rate capture of the sample, named after the utc of the row above
+        trace.writeToFile(ProgramSettings::TRACE_FOLDER, utc, currentTaskId, status.currentValve);
     }
 
     template <typename T, typename... Args>
@@ -328,7 +486,7 @@ public:
             if (currentTaskId == id) {
                 // NOTE: Check logic here. Maybe not be correct yet
                 if (shouldStopCurrentTask) {
-                    cancel("delayTaskExecution");
+                    timers.cancel(taskExecution);
                     // if (status.currentStateName != HyperFlush::STOP) {
                     // 	newStateController.stop();
                     // }
@@ -352,11 +510,9 @@ public:
                 // Prepare an action to execute at exact time
                 const auto timeUntil = task.schedule - time_now;
 
-                TimedAction delayTaskExecution;
-                delayTaskExecution.name     = "delayTaskExecution";
-                delayTaskExecution.interval = secsToMillis(timeUntil);
-                delayTaskExecution.callback = [this]() { newStateController.begin(); };
-                run(delayTaskExecution);  // async, will be execute later
+                timers.cancel(taskExecution);
+                taskExecution = timers.schedule(
+                    secsToMillis(timeUntil), [this]() { newStateController.begin(); });
 
                 newStateController.configure(task);
 
@@ -433,9 +589,193 @@ public:
      *  ──────────────────────────────────────────────────────────────────────────── */
     void update() override {
         KPController::update();
+        if (power.isShuttingDown()) {
+            return;
+        }
+
+        if (shuttingDown) {
+            halt(TRACE, "Shutdown. This message should not be displayed. Check power module");
+        }
+
         if (!status.isProgrammingMode() && !status.preventShutdown) {
-            shutdown();
+            return sleepOrShutdown();
+        }
+
+        // Requests may need any valve or task
+        if (wifi.isStarted()) {
+            loadDeferred();
+        }
+
+        // An open event stream keeps the radio up even without requests
+        if (events.isConnected()) {
+            wifi.touch();
+        }
+
+        idleUntilNextEvent();
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Wait for the next task in standby if that takes less energy than booting
+     *  again, otherwise cut the power. Standby keeps drawing for the whole gap while a
+     *  power cut costs one boot, whose duration is measured on every boot. Gaps within
+     *  config.sessionWindow always wait in standby so close tasks run in one session.
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void sleepOrShutdown() {
+        using namespace ProgramSettings;
+
+        // Wake up 8 secs ahead like scheduleNextActiveTask does. -1 when nothing is scheduled.
+        const auto ids        = tm.getActiveSortedTaskIds();
+        const time_t wakeTime = ids.empty() ? 0 : tm.tasks[ids.front()].schedule - 8;
+        const long gap        = ids.empty() ? -1 : long(wakeTime - now());
+
+        const double standbyCost = gap * STANDBY_CURRENT_MA;
+        const double bootCost    = bootDuration / 1000.0 * BOOT_CURRENT_MA;
+        const bool cheaper       = gap > 0 && gap <= STANDBY_MAX_GAP && standbyCost < bootCost;
+        const bool session       = gap > 0 && gap <= config.sessionWindow;
+        const bool standby       = cheaper || session;
+        if (!standby) {
+            logPowerDecision("shutdown", gap);
+            return shutdown();
+        }
+
+        // Early wakes (flow pulse, button) come back here to finish the same wait
+        if (wakeTime != standbyWakeTime) {
+            logPowerDecision(session ? "session" : "standby", gap);
+            standbyWakeTime = wakeTime;
+        }
+
+        sequencer.clear();
+        pump.off();
+        shift.writeAllRegistersLow();
+        intake.off();
+
+        // Woken up by the RTC interrupt, which schedules the task as after a power cut
+        power.sleepFor(gap);
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Fast path of setup() for a wake up with nothing due: arm the alarm for the
+     *  task in the record and cut the power again.
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void rearmFromRecord(const ResumeRecord & record) {
+        println("Resume: task ", record.taskId, " at ", record.schedule);
+        if (record.taskId != 0) {
+            power.scheduleNextAlarm(record.schedule - 8);
+        }
+
+        power.shutdown();
+        shuttingDown = true;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Load only what the due task of the record needs: its task file and the
+     *  valves it has left. The other valves take their status from the bitmap until
+     *  loadDeferred() reads them.
+     *
+     *  @return false if the task file does not match the record
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    bool loadFromRecord(const ResumeRecord & record) {
+        if (!tm.loadTaskFile(record.taskFile, record.taskId, config.taskFolder)) {
+            return false;
+        }
+
+        for (size_t i = 0; i < vm.valves.size(); i++) {
+            if (record.sampledValves >> i & 1) {
+                vm.setValveStatus(i, ValveStatus::sampled);
+            }
+        }
+
+        const Task & task = tm.tasks.at(record.taskId);
+        loadedValves      = 0;
+        for (size_t i = record.valveOffset; i < task.valves.size(); i++) {
+            loadedValves |= 1ul << task.valves[i];
+        }
+
+        vm.loadValvesFromDirectory(config.valveFolder, ~loadedValves);
+        deferredLoad = true;
+        println("Resume: task ", record.taskId, " due, loaded its valves only");
+        return true;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Load the valves and tasks left out by a fast resume. Called before
+     *  anything that reads or writes all of them: STOP, shutdown, API requests and log
+     *  index rebuilds. What the running task changed in memory is kept.
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void loadDeferred() {
+        if (!deferredLoad) {
+            return;
+        }
+
+        deferredLoad = false;
+        vm.loadValvesFromDirectory(config.valveFolder, loadedValves);
+        tm.loadTasksFromDirectory(config.taskFolder);
+    }
+
+    // Right after the task files were written: the order of the map is the file order
+    void writeResumeRecord() {
+        ResumeRecord record;
+        for (const Valve & valve : vm.valves) {
+            if (valve.status == ValveStatus::sampled) {
+                record.sampledValves |= 1ul << valve.id;
+            }
+        }
+
+        const auto ids = tm.getActiveSortedTaskIds();
+        if (!ids.empty()) {
+            const Task & task  = tm.tasks[ids.front()];
+            record.taskId      = task.id;
+            record.schedule    = task.schedule;
+            record.valveOffset = task.valveOffsetStart;
+            for (const auto & kv : tm.tasks) {
+                if (kv.first == task.id) {
+                    break;
+                }
+
+                record.taskFile++;
+            }
+        }
+
+        record.write(power.rtc);
+    }
+
+    void logPowerDecision(const char * decision, long gap) {
+        SD.begin(HardwarePins::SD_CARD);
+        const bool exists = SD.exists(ProgramSettings::POWER_LOG_FILE);
+        File log          = SD.open(ProgramSettings::POWER_LOG_FILE, FILE_WRITE);
+        if (!exists) {
+            log.println("UTC, Decision, Gap (s), Boot Duration (ms)");
         }
+
+        KPStringBuilder<64> row{now(), ",", decision, ",", gap, ",", bootDuration};
+        log.println(row);
+        log.close();
+        println("Power: ", row);
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Sleep the CPU until the next timer, capped so the server and the sensors
+     *  are still polled regularly. Only when nothing is moving: both state machines are
+     *  idle and no actuation is in progress.
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void idleUntilNextEvent() {
+        const bool busy = !newStateController.isInState(New::IDLE)
+                          || !hyperFlushStateController.isInState(HyperFlush::IDLE)
+                          || !sequencer.isIdle() || pump.isRamping() || binarySerial.isActive();
+        if (busy) {
+            return;
+        }
+
+        const unsigned long duration = std::min<unsigned long>(
+            timers.timeUntilNextDeadline(), ProgramSettings::IDLE_SLEEP_MAX);
+        const unsigned long ticks = flowTickCount;
+        idle.sleep(duration, [this, ticks]() {
+            return alarmTriggered || flowTickCount != ticks || Serial.available() > 0;
+        });
     }
 
     /** ────────────────────────────────────────────────────────────────────────────
@@ -443,14 +783,43 @@ public:
      *
      *  ──────────────────────────────────────────────────────────────────────────── */
     void shutdown() {
+        if (shuttingDown) {
+            return;
+        }
+
+        sequencer.clear();
         pump.off();                    // Turn off motor
         shift.writeAllRegistersLow();  // Turn off all TPIC devices
         intake.off();
 
+        loadDeferred();
         tm.writeToDirectory();
         vm.writeToDirectory();
+        writeResumeRecord();
+
+        // The power module pulse ends in Power::update(). We only get past it in update()
+        // if the power was not actually cut.
         power.shutdown();
-        halt(TRACE, "Shutdown. This message should not be displayed. Check power module");
+        shuttingDown = true;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Move the current task on to its next valve within a batch. Nothing is
+     *  written to the SD card; STOP saves the valves and the task once the batch is over.
+     *
+     *  @return false if the task has no valve left
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    bool advanceBatch() {
+        Task & task = tm.tasks.at(currentTaskId);
+        if (task.valveOffsetStart + 1 >= task.getNumberOfValves()) {
+            return false;
+        }
+
+        vm.setValveStatus(status.currentValve, ValveStatus::sampled);
+        task.valveOffsetStart++;
+        vm.setValveStatus(task.getCurrentValveId(), ValveStatus::operating);
+        println("Batch: next valve ", status.currentValve);
+        return true;
     }
 
     void invalidateTaskAndFreeUpValves(Task & task) {
@@ -470,4 +839,64 @@ private:
             currentTaskId = 0;
         }
     }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Make sure the log starts with the given header. A log written with a
+     *  different header is moved to <name>.001 (or the next free number) first so its
+     *  rows stay with the columns they were written under.
+     *
+     *  @param path Path to the log
+     *  @param header Header row including the line break
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void prepareLog(const char * path, const char * header) {
+        File log = SD.open(path, FILE_READ);
+        if (log) {
+            bool matches = true;
+            for (const char * c = header; *c && matches; c++) {
+                matches = log.read() == *c;
+            }
+
+            if (matches) {
+                log.close();
+                return;
+            }
+
+            archiveLog(log, path);
+        }
+
+        log = SD.open(path, FILE_WRITE);
+        log.println(header);
+        log.close();
+    }
+
+    // Copies the log to the first free <name>.<nnn> and removes it. SD has no rename.
+    void archiveLog(File & log, const char * path) {
+        char archive[ProgramSettings::SD_FILE_NAME_LENGTH];
+        strncpy(archive, path, sizeof(archive) - 5);
+        archive[sizeof(archive) - 5] = 0;
+        char * extension             = strrchr(archive, '.');
+        if (!extension) {
+            extension = archive + strlen(archive);
+        }
+
+        for (int number = 1; number < 1000; number++) {
+            snprintf(extension, 5, ".%03d", number);
+            if (!SD.exists(archive)) {
+                break;
+            }
+        }
+
+        println("Log header changed, moving ", path, " to ", archive);
+        File copy = SD.open(archive, FILE_WRITE);
+        uint8_t buffer[128];
+        int read;
+        log.seek(0);
+        while ((read = log.read(buffer, sizeof(buffer))) > 0) {
+            copy.write(buffer, read);
+        }
+
+        copy.close();
+        log.close();
+        SD.remove(path);
+    }
 };
\ No newline at end of file
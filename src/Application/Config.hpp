@@ -26,6 +26,21 @@ public:
     char taskFolder[ProgramSettings::SD_FILE_NAME_LENGTH]  = {0};
     char valveFolder[ProgramSettings::SD_FILE_NAME_LENGTH] = {0};
 
+    // Preloading (HyperFlush). Each stage ends on volume, with time as a cap. A volume of 0
+    // means time only.
+    int hyperFlushTime     = 5;
+    float hyperFlushVolume = 0;
+    int preloadTime        = 5;
+    float preloadVolume    = 0;
+
+    // Offshoots preloaded at once. Fewer once the pressure goes over the limit (0: none).
+    int preloadGroupSize       = 1;
+    float preloadPressureLimit = 0;
+
+    // The next task is waited for in standby instead of a power cycle when due within this
+    // many seconds, whatever sleepOrShutdown() estimates (0: leave it to the estimate)
+    int sessionWindow = 0;
+
 public:
     // Config()			   = delete;
     // Config(const Config &) = delete;
@@ -69,6 +84,16 @@ public:
         strncpy(statusFile, source[FILE_STATUS], SD_FILE_NAME_LENGTH);
         strncpy(taskFolder, source[FOLDER_TASK], SD_FILE_NAME_LENGTH);
         strncpy(valveFolder, source[FOLDER_VALVE], SD_FILE_NAME_LENGTH);
+
+        hyperFlushTime   = source[HYPERFLUSH_TIME] | 5;
+        hyperFlushVolume = source[HYPERFLUSH_VOLUME] | 0.0f;
+        preloadTime      = source[PRELOAD_TIME] | 5;
+        preloadVolume    = source[PRELOAD_VOLUME] | 0.0f;
+
+        preloadGroupSize     = source[PRELOAD_GROUP_SIZE] | 1;
+        preloadPressureLimit = source[PRELOAD_PRESSURE_LIMIT] | 0.0f;
+
+        sessionWindow = source[SESSION_WINDOW] | 0;
     }
 
 #pragma region JSONENCODABLE
@@ -88,7 +113,12 @@ public:
 
         return dest[VALVE_UPPER_BOUND].set(valveUpperBound) && dest[FILE_LOG].set(logFile)
                && dest[FILE_STATUS].set(statusFile) && dest[FOLDER_TASK].set(taskFolder)
-               && dest[FOLDER_VALVE].set(valveFolder);
+               && dest[FOLDER_VALVE].set(valveFolder) && dest[HYPERFLUSH_TIME].set(hyperFlushTime)
+               && dest[HYPERFLUSH_VOLUME].set(hyperFlushVolume)
+               && dest[PRELOAD_TIME].set(preloadTime) && dest[PRELOAD_VOLUME].set(preloadVolume)
+               && dest[PRELOAD_GROUP_SIZE].set(preloadGroupSize)
+               && dest[PRELOAD_PRESSURE_LIMIT].set(preloadPressureLimit)
+               && dest[SESSION_WINDOW].set(sessionWindow);
     }
 #pragma endregion
 #pragma region PRINTABLE
@@ -47,14 +47,38 @@ namespace HardwarePins {
 namespace ProgramSettings {
     __k_auto CONFIG_FILE_PATH          = "config.js";
     __k_auto SD_FILE_NAME_LENGTH       = 13;
-    __k_auto CONFIG_JSON_BUFFER_SIZE   = 800;
+    __k_auto CONFIG_JSON_BUFFER_SIZE   = 1000;
     __k_auto STATUS_JSON_BUFFER_SIZE   = 800;
+    __k_auto STATUS_BODY_BUFFER_SIZE   = 600;
     __k_auto TASK_JSON_BUFFER_SIZE     = 800;
     __k_auto TASKREF_JSON_BUFFER_SIZE  = 50;
     __k_auto MAX_VALVES                = 24;
     __k_auto VALVE_JSON_BUFFER_SIZE    = 500;
+    __k_auto VALVE_FILE_BUFFER_SIZE    = 800;  // Decoding copies the keys of the sample summary
     __k_auto VALVEREF_JSON_BUFFER_SIZE = 50;
     __k_auto VALVE_GROUP_LENGTH        = 25;
+    __k_auto DETAIL_LOG_FILE           = "detail.csv";
+    __k_auto DETAIL_LOG_INDEX_INTERVAL = 60;  // One index entry per minute of detail log
+    __k_auto LOG_LIST_BUFFER_SIZE      = 600;
+    __k_auto TRACE_FOLDER              = "traces";
+    __k_auto TRACE_FREQ_HZ             = 20;
+    __k_auto TRACE_CAPACITY            = 384;  // 9 bytes per record
+    __k_auto PUMP_RAMP_TIME            = 500;  // Soft start of the pump in SAMPLE (ms)
+    __k_auto TIMER_CAPACITY            = 16;   // Pending timers in the timer wheel
+    __k_auto IDLE_SLEEP_MIN            = 2;    // Not worth sleeping for less (ms)
+    __k_auto IDLE_SLEEP_MAX            = 100;  // Bounds server and sensor latency (ms)
+    __k_auto MCU_ACTIVE_CURRENT_MA     = 6.0;  // SAMD21 at 48 MHz running, typical
+    __k_auto MCU_IDLE_CURRENT_MA       = 2.5;  // SAMD21 at 48 MHz in IDLE_0, typical
+    __k_auto POWER_LOG_FILE            = "power.csv";
+    __k_auto BOOT_LOG_FILE             = "boot.csv";
+    __k_auto BOOT_TIMELINE_CAPACITY    = 16;
+    __k_auto METRICS_JSON_BUFFER_SIZE  = 1536;
+    __k_auto STANDBY_MAX_GAP           = 600;   // Longer gaps always cut the power (s)
+    __k_auto STANDBY_CURRENT_MA        = 1.5;   // Board draw in standby, radio off
+    __k_auto BOOT_CURRENT_MA           = 60.0;  // Average draw from power on to end of setup
+    __k_auto WIFI_IDLE_TIMEOUT         = 600;   // Radio off after this long without requests (s)
+    // Alarm 1 matches the day of month, so it can be at most 27 days ahead (s)
+    __k_auto RTC_ALARM_MAX_DELAY       = 27 * 24 * 3600ul;
 };  // namespace ProgramSettings
 
 namespace TaskSettings {
@@ -71,40 +95,67 @@ namespace TaskSettings {
 // These are used to retrieve values from ArduinoJson's JSON Object
 
 namespace ConfigKeys {
-    __k_auto VALVES_FREE       = "freeValves";
-    __k_auto VALVE_UPPER_BOUND = "valveUpperBound";
-    __k_auto FILE_LOG          = "logFile";
-    __k_auto FILE_STATUS       = "statusFile";
-    __k_auto FOLDER_TASK       = "taskFolder";
-    __k_auto FOLDER_VALVE      = "valveFolder";
+    __k_auto VALVES_FREE            = "freeValves";
+    __k_auto VALVE_UPPER_BOUND      = "valveUpperBound";
+    __k_auto FILE_LOG               = "logFile";
+    __k_auto FILE_STATUS            = "statusFile";
+    __k_auto FOLDER_TASK            = "taskFolder";
+    __k_auto FOLDER_VALVE           = "valveFolder";
+    __k_auto HYPERFLUSH_TIME        = "hyperFlushTime";
+    __k_auto HYPERFLUSH_VOLUME      = "hyperFlushVolume";
+    __k_auto PRELOAD_TIME           = "preloadTime";
+    __k_auto PRELOAD_VOLUME         = "preloadVolume";
+    __k_auto PRELOAD_GROUP_SIZE     = "preloadGroupSize";
+    __k_auto PRELOAD_PRESSURE_LIMIT = "preloadPressureLimit";
+    __k_auto SESSION_WINDOW         = "sessionWindow";
 }  // namespace ConfigKeys
 
 namespace TaskKeys {
-    __k_auto ID              = "id";
-    __k_auto NAME            = "name";
-    __k_auto STATUS          = "status";
-    __k_auto VALVES          = "valves";
-    __k_auto VALVES_OFFSET   = "valvesOffset";
-    __k_auto CREATED_AT      = "createdAt";
-    __k_auto SCHEDULE        = "schedule";
-    __k_auto TIME_BETWEEN    = "timeBetween";
-    __k_auto NOTES           = "notes";
-    __k_auto DELETE          = "deleteOnCompletion";
-    __k_auto FLUSH_TIME      = "flushTime";
-    __k_auto FLUSH_VOLUME    = "flushVolume";
-    __k_auto SAMPLE_TIME     = "sampleTime";
-    __k_auto SAMPLE_PRESSURE = "samplePressure";
-    __k_auto SAMPLE_VOLUME   = "sampleVolume";
-    __k_auto DRY_TIME        = "dryTime";
-    __k_auto PRESERVE_TIME   = "preserveTime";
+    __k_auto ID                     = "id";
+    __k_auto NAME                   = "name";
+    __k_auto STATUS                 = "status";
+    __k_auto VALVES                 = "valves";
+    __k_auto VALVES_OFFSET          = "valvesOffset";
+    __k_auto CREATED_AT             = "createdAt";
+    __k_auto SCHEDULE               = "schedule";
+    __k_auto TIME_BETWEEN           = "timeBetween";
+    __k_auto NOTES                  = "notes";
+    __k_auto DELETE                 = "deleteOnCompletion";
+    __k_auto FLUSH_TIME             = "flushTime";
+    __k_auto FLUSH_VOLUME           = "flushVolume";
+    __k_auto SAMPLE_TIME            = "sampleTime";
+    __k_auto SAMPLE_PRESSURE        = "samplePressure";
+    __k_auto SAMPLE_VOLUME          = "sampleVolume";
+    __k_auto SAMPLE_CLOG_RATIO      = "sampleClogRatio";
+    __k_auto SAMPLE_CLOG_WINDOW     = "sampleClogWindow";
+    __k_auto SAMPLE_PRESSURE_TARGET = "samplePressureTarget";
+    __k_auto BATCH                  = "batch";
+    __k_auto DRY_TIME               = "dryTime";
+    __k_auto PRESERVE_TIME          = "preserveTime";
 }  // namespace TaskKeys
 
 namespace ValveKeys {
     __k_auto ID     = "id";
     __k_auto STATUS = "status";
     __k_auto GROUP  = "group";
+    __k_auto SAMPLE = "sample";
 }  // namespace ValveKeys
 
+namespace SampleKeys {
+    __k_auto CONDITION         = "condition";
+    __k_auto DURATION          = "duration";
+    __k_auto PRESSURE_MEAN     = "pressureMean";
+    __k_auto PRESSURE_MIN      = "pressureMin";
+    __k_auto PRESSURE_MAX      = "pressureMax";
+    __k_auto PRESSURE_VARIANCE = "pressureVariance";
+    __k_auto FLOW_MEAN         = "flowMean";
+    __k_auto FLOW_MIN          = "flowMin";
+    __k_auto FLOW_MAX          = "flowMax";
+    __k_auto FLOW_VARIANCE     = "flowVariance";
+    __k_auto TIME_TO_PRESSURE  = "timeToPressure";
+    __k_auto VOLUME            = "volume";
+}  // namespace SampleKeys
+
 namespace StatusKeys {
     __k_auto VALVE_ID        = "valveId";
     __k_auto VALVE_GROUP     = "valveGroup";
@@ -123,6 +174,10 @@ namespace StatusKeys {
     __k_auto CURRENT_STATE   = "currentState";
     __k_auto LOW_BATTERY     = "lowBattery";
     __k_auto SAMPLE_VOLUME   = "sampleVolume";
+    __k_auto SEQUENCE        = "seq";
+    __k_auto EPOCH           = "epoch";
+    __k_auto IS_DELTA        = "delta";
+    __k_auto VALVES_CHANGED  = "valvesChanged";
 };  // namespace StatusKeys
 
 #undef __k_auto
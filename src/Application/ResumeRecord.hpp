@@ -0,0 +1,66 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <DS3232RTC.h>
+
+#include <Application/Constants.hpp>
+#include <Utilities/Framing.hpp>
+
+//
+// ──────────────────────────────────────────────────────────────── I ──────────
+//   :::::: R E S U M E   R E C O R D : :  :   :    :     :        :          :
+// ──────────────────────────────────────────────────────────────────────────
+//
+// What the next boot needs to know about the schedule, kept in the battery backed SRAM of
+// the DS3232 so it survives the power cut. Written right before the power is cut and
+// invalidated by every boot that goes on to use the SD card, so a valid record always
+// matches the SD card. With it, an alarm wake up for the next task loads only that task and its valves;
+// one for a task that is not due yet (a wait chained in steps of RTC_ALARM_MAX_DELAY) only
+// re-arms the alarm without touching the SD card at all.
+//
+struct __attribute__((packed)) ResumeRecord {
+    static constexpr uint8_t address        = 0x14;  // Start of the user SRAM
+    static constexpr uint8_t currentVersion = 3;
+
+    uint8_t version        = currentVersion;
+    int32_t taskId         = 0;  // Next active task, 0 if none
+    uint16_t taskFile      = 0;  // Of the next task: <task folder>/task-<taskFile>.js
+    uint32_t schedule      = 0;  // Of the next task
+    uint8_t valveOffset    = 0;  // Of the next task
+    uint32_t sampledValves = 0;  // Bit i is set if valve i has been sampled
+    uint16_t crc           = 0;
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Read the record from the RTC
+     *
+     *  @return true if the record is intact and of the current version
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    bool read(DS3232RTC & rtc) {
+        rtc.readRTC(address, reinterpret_cast<uint8_t *>(this), sizeof(ResumeRecord));
+        return version == currentVersion && crc == checksum();
+    }
+
+    void write(DS3232RTC & rtc) {
+        version = currentVersion;
+        crc     = checksum();
+        rtc.writeRTC(address, reinterpret_cast<uint8_t *>(this), sizeof(ResumeRecord));
+    }
+
+    static void invalidate(DS3232RTC & rtc) {
+        uint8_t zero = 0;
+        rtc.writeRTC(address, &zero, 1);
+    }
+
+    // Within the 10 secs window in which scheduleNextActiveTask() starts a task
+    bool isDue(time_t utc) const {
+        return taskId != 0 && long(schedule - utc) <= 10;
+    }
+
+private:
+    uint16_t checksum() const {
+        return Framing::crc16(
+            reinterpret_cast<const uint8_t *>(this), sizeof(ResumeRecord) - sizeof(crc));
+    }
+};
+
+static_assert(sizeof(ResumeRecord) < 32, "Must fit in a single I2C transfer");
+static_assert(ProgramSettings::MAX_VALVES <= 32, "Sampled valves must fit in the bitmap");
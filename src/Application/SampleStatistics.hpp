@@ -0,0 +1,108 @@
+#pragma once
+#include <KPFoundation.hpp>
+
+#include <Components/SensorArrayObserver.hpp>
+#include <Utilities/RunningStatistics.hpp>
+#include <Valve/SampleSummary.hpp>
+
+//
+// ────────────────────────────────────────────────────────────────────────── I ──────────
+//   :::::: S A M P L E   S T A T I S T I C S : :  :   :    :     :        :          :
+// ────────────────────────────────────────────────────────────────────────────────────
+//
+// Online aggregates of the pressure and flow readings during SAMPLE. Every reading is
+// folded in as it arrives so nothing is buffered. The result is kept in `summary` once
+// the sample stops and goes to the sample log and the valve record.
+//
+class SampleStatistics : public SensorArrayObserver {
+private:
+    bool active = false;
+    RunningStatistics pressure;
+    RunningStatistics flow;
+
+    float pressureThreshold     = 0;
+    unsigned long startTime     = 0;
+    unsigned long lastFlowTime  = 0;
+    float lastLpm               = 0;
+    double volume               = 0;
+    unsigned long thresholdTime = 0;
+    bool thresholdReached       = false;
+
+public:
+    SampleSummary summary;
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Start collecting for a new sample
+     *
+     *  @param threshold Sample pressure. The time until it is first reached is recorded.
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void start(float threshold) {
+        pressure.reset();
+        flow.reset();
+        pressureThreshold = threshold;
+        startTime         = millis();
+        lastFlowTime      = startTime;
+        lastLpm           = 0;
+        volume            = 0;
+        thresholdReached  = false;
+        summary           = SampleSummary();
+        active            = true;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Stop collecting and fill in the summary
+     *
+     *  @param condition What ended the sample (ex: Sample::condition)
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void stop(const char * condition) {
+        if (!active) {
+            return;
+        }
+
+        active = false;
+        strncpy(summary.condition, condition ? condition : "stop", sizeof(summary.condition) - 1);
+        summary.duration         = (millis() - startTime) / 1000;
+        summary.pressureMean     = pressure.mean();
+        summary.pressureMin      = pressure.minimum();
+        summary.pressureMax      = pressure.maximum();
+        summary.pressureVariance = pressure.variance();
+        summary.flowMean         = flow.mean();
+        summary.flowMin          = flow.minimum();
+        summary.flowMax          = flow.maximum();
+        summary.flowVariance     = flow.variance();
+        summary.timeToPressure   = thresholdReached ? long(thresholdTime - startTime) / 1000 : -1;
+        summary.volume           = volume;
+    }
+
+private:
+    const char * SensorManagerObserverName() const override {
+        return "SampleStatistics-SensorArray Observer";
+    }
+
+    void pressureSensorDidUpdate(PressureSensor::SensorData & values) override {
+        if (!active) {
+            return;
+        }
+
+        const float value = std::get<0>(values);
+        pressure.add(value);
+        if (!thresholdReached && value >= pressureThreshold) {
+            thresholdReached = true;
+            thresholdTime    = millis();
+        }
+    }
+
+    void flowSensorDidUpdate(TurbineFlowSensor::SensorData & values) override {
+        if (!active) {
+            return;
+        }
+
+        // Trapezoidal integration of the flow rate over time
+        const unsigned long time = millis();
+        const float lpm          = values.lpm;
+        volume += (lpm + lastLpm) / 2 * (time - lastFlowTime) / 60000.0;
+        flow.add(lpm);
+        lastLpm      = lpm;
+        lastFlowTime = time;
+    }
+};
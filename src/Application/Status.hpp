@@ -32,6 +32,38 @@ public:
 
     bool isFull          = false;
     bool preventShutdown = false;
+    bool lowBattery      = false;
+
+    // Incremented every time an encoded field changes. Starts at 1 so that 0 can be used
+    // by caches as "never encoded".
+    unsigned long sequence = 1;
+
+    // Random per boot. Sequence numbers restart on every boot so they only mean something
+    // together with the epoch they were handed out in.
+    long epoch = 0;
+
+    // Encoded fields tracked individually for delta encoding
+    enum Field : uint8_t {
+        PRESSURE,
+        TEMPERATURE,
+        BAROMETRIC,
+        WATER_VOLUME,
+        WATER_DEPTH,
+        WATER_FLOW,
+        SAMPLE_VOLUME,
+        CURRENT_TASK,
+        CURRENT_STATE,
+        LOW_BATTERY,
+        FIELD_COUNT
+    };
+
+    // Sequence number at which each field/valve last changed
+    std::array<unsigned long, FIELD_COUNT> fieldSequences{};
+    std::vector<unsigned long> valveSequences;
+
+    // Sequence number at which the valve array was last replaced. Deltas cannot be computed
+    // for clients that are behind this point.
+    unsigned long baseSequence = 1;
 
     const char * currentStateName = nullptr;
     const char * currentTaskName  = nullptr;
@@ -48,9 +80,37 @@ public:
     void init(Config & config) {
         valves.resize(config.numberOfValves);
         memcpy(valves.data(), config.valves, sizeof(int) * config.numberOfValves);
+        resetValveSequences();
     }
 
 private:
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Assign the value and bump the sequence number if it is different
+     *
+     *  @param id Field identifier used for delta encoding
+     *  @param field Reference to the member variable
+     *  @param value New value
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    template <typename T>
+    void update(Field id, T & field, const T & value) {
+        if (field != value) {
+            field              = value;
+            fieldSequences[id] = ++sequence;
+        }
+    }
+
+    void updateValve(int id, int valveStatus) {
+        if (valves[id] != valveStatus) {
+            valves[id]         = valveStatus;
+            valveSequences[id] = ++sequence;
+        }
+    }
+
+    void resetValveSequences() {
+        baseSequence = ++sequence;
+        valveSequences.assign(valves.size(), baseSequence);
+    }
+
     const char * ValveObserverName() const override {
         return "Status-Valve Observer";
     }
@@ -72,7 +132,7 @@ private:
             currentValve = valve.id;
         }
 
-        valves[valve.id] = valve.status;
+        updateValve(valve.id, valve.status);
     }
 
     void valveArrayDidUpdate(const std::vector<Valve> & valves) override {
@@ -83,7 +143,7 @@ private:
     }
 
     void stateDidBegin(const KPState * current) override {
-        currentStateName = current->getName();
+        update(CURRENT_STATE, currentStateName, current->getName());
     }
 
     //
@@ -93,31 +153,37 @@ private:
     //
 
     void flowSensorDidUpdate(TurbineFlowSensor::SensorData & values) override {
-        waterFlow    = values.lpm;
-        waterVolume  = values.volume;
-        sampleVolume = values.volume;
+        update(WATER_FLOW, waterFlow, float(values.lpm));
+        update(WATER_VOLUME, waterVolume, float(values.volume));
+        update(SAMPLE_VOLUME, sampleVolume, float(values.volume));
     }
 
     void pressureSensorDidUpdate(PressureSensor::SensorData & values) override {
-        pressure    = std::get<0>(values);
-        temperature = std::get<1>(values);
+        update(PRESSURE, pressure, std::get<0>(values));
+        update(TEMPERATURE, temperature, std::get<1>(values));
         maxPressure = max(pressure, maxPressure);
     }
 
     void baro1DidUpdate(BaroSensor::SensorData & values) override {
-        barometric = std::get<0>(values);
+        update(BAROMETRIC, barometric, std::get<0>(values));
     }
 
     void baro2DidUpdate(BaroSensor::SensorData & values) override {
-        waterDepth = std::get<0>(values);
+        update(WATER_DEPTH, waterDepth, std::get<0>(values));
     }
 
-    bool isBatteryLow() const {
+public:
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Sample the battery voltage. This is called periodically by the app
+     *  instead of on every encode since analogRead is comparatively slow.
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void updateBatteryStatus() {
         analogReadResolution(10);
-        return analogRead(HardwarePins::BATTERY_VOLTAGE) <= 860;  // 860 is around 12V of battery
+        // 860 is around 12V of battery
+        update(LOW_BATTERY, lowBattery, analogRead(HardwarePins::BATTERY_VOLTAGE) <= 860);
     }
 
-public:
     /** ────────────────────────────────────────────────────────────────────────────
      *  @brief Override_Mode_Pin is connected to an external switch which is active low.
      *  Override_Mode_Pin is connected to an external switch which is active low.
@@ -150,6 +216,7 @@ public:
         const JsonArrayConst & source_valves = source[StatusKeys::VALVES].as<JsonArrayConst>();
         valves.resize(source_valves.size());
         copyArray(source_valves, valves.data(), valves.size());
+        resetValveSequences();
     }
 
 #pragma endregion JSONDECODABLE
@@ -177,11 +244,57 @@ public:
 			&& dest[SENSOR_FLOW].set(waterFlow) 
 			&& dest[CURRENT_TASK].set(currentTaskName)
 			&& dest[CURRENT_STATE].set(currentStateName) 
-            && dest[LOW_BATTERY].set(isBatteryLow())
+            && dest[LOW_BATTERY].set(lowBattery)
             && dest[SAMPLE_VOLUME].set(sampleVolume);
         // clang-format on
     }
 
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Check if changes since the given sequence number can be encoded as a
+     *  delta. Otherwise, the client needs a full snapshot.
+     *
+     *  @param sinceEpoch Epoch the client last saw. Anything else is from another boot.
+     *  @param since Sequence number the client last saw
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    bool canEncodeDelta(long sinceEpoch, unsigned long since) const {
+        return sinceEpoch == epoch && since >= baseSequence && since <= sequence;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Encode only the fields and valves that changed after the given sequence
+     *  number. Valves are encoded as an object of index to status.
+     *
+     *  @param dest Destination JSON object
+     *  @param since Sequence number the client last saw. See canEncodeDelta().
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    bool encodeDeltaJSON(const JsonVariant & dest, unsigned long since) const {
+        using namespace StatusKeys;
+        const auto changed = [&](Field id) { return fieldSequences[id] > since; };
+
+        bool success = true;
+        for (size_t i = 0; i < valves.size(); i++) {
+            if (valveSequences[i] > since) {
+                char key[4];
+                itoa(i, key, 10);
+                success = success && dest[VALVES_CHANGED][key].set(valves[i]);
+            }
+        }
+
+        // clang-format off
+        return success
+            && (!changed(PRESSURE) || dest[SENSOR_PRESSURE].set(pressure))
+            && (!changed(TEMPERATURE) || dest[SENSOR_TEMP].set(temperature))
+            && (!changed(BAROMETRIC) || dest[SENSOR_BARO].set(barometric))
+            && (!changed(WATER_VOLUME) || dest[SENSOR_VOLUME].set(waterVolume))
+            && (!changed(WATER_DEPTH) || dest[SENSOR_DEPTH].set(waterDepth))
+            && (!changed(WATER_FLOW) || dest[SENSOR_FLOW].set(waterFlow))
+            && (!changed(CURRENT_TASK) || dest[CURRENT_TASK].set(currentTaskName))
+            && (!changed(CURRENT_STATE) || dest[CURRENT_STATE].set(currentStateName))
+            && (!changed(LOW_BATTERY) || dest[LOW_BATTERY].set(lowBattery))
+            && (!changed(SAMPLE_VOLUME) || dest[SAMPLE_VOLUME].set(sampleVolume));
+        // clang-format on
+    }
+
 #pragma endregion JSONENCODABLE
 #pragma region PRINTABLE
     size_t printTo(Print & printer) const override {
@@ -0,0 +1,76 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <LowPower.h>
+
+#include <Application/Constants.hpp>
+
+//
+// ──────────────────────────────────────────────────────────── I ──────────
+//   :::::: I D L E   S L E E P : :  :   :    :     :        :          :
+// ──────────────────────────────────────────────────────────────────────
+//
+// Puts the CPU in idle sleep (clock gated, peripherals and interrupts running) until the
+// next deadline or until an interrupt brings in something to handle. Any interrupt resumes
+// the CPU, including the 1 ms SysTick, so the wait is a series of short naps. After each
+// one the caller's wake check decides whether to return early.
+//
+// How late the loop wakes up is measured where it matters, on the timer callbacks (see
+// TimerWheel::latency). The statistics here give the share of time spent asleep and the
+// average MCU current it results in.
+//
+struct IdleStatistics {
+    unsigned long sleeps     = 0;
+    unsigned long earlyWakes = 0;  // Woken by an event before the deadline
+    unsigned long totalSleep = 0;  // Milliseconds spent asleep
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Estimated average MCU current since boot, from the time asleep and the
+     *  typical active and idle draw. Compare with MCU_ACTIVE_CURRENT_MA, the draw of
+     *  the loop spinning without idle sleep.
+     *
+     *  @param uptime Milliseconds since boot
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    float averageCurrent(unsigned long uptime) const {
+        using namespace ProgramSettings;
+        if (uptime == 0) {
+            return MCU_ACTIVE_CURRENT_MA;
+        }
+
+        const float asleep = float(totalSleep) / uptime;
+        return asleep * MCU_IDLE_CURRENT_MA + (1 - asleep) * MCU_ACTIVE_CURRENT_MA;
+    }
+};
+
+class IdleSleep {
+public:
+    IdleStatistics statistics;
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Sleep for up to the given time
+     *
+     *  @param duration Milliseconds until the next deadline
+     *  @param shouldWake Called after every interrupt. Return true to stop sleeping.
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    template <typename WakeCheck>
+    void sleep(unsigned long duration, WakeCheck && shouldWake) {
+        if (duration < ProgramSettings::IDLE_SLEEP_MIN) {
+            return;
+        }
+
+        const unsigned long start = millis();
+        bool early                = false;
+        while (millis() - start < duration) {
+            LowPower.idle(IDLE_0);
+            if (shouldWake()) {
+                early = true;
+                break;
+            }
+        }
+
+        statistics.sleeps++;
+        statistics.totalSleep += millis() - start;
+        if (early) {
+            statistics.earlyWakes++;
+        }
+    }
+};
@@ -7,6 +7,12 @@ public:
     using KPComponent::KPComponent;
     virtual void on()  = 0;
     virtual void off() = 0;
+
+    // Milliseconds the valve needs to move after on() or off(). Wait for this with the
+    // sequencer before relying on the new position.
+    virtual unsigned long settleTime() const {
+        return 0;
+    }
 };
 
 class LatchIntake : public Intake {
@@ -19,7 +25,6 @@ public:
         shift.setPin(controlPin, HIGH);
         shift.setPin(reversePin, LOW);
         shift.write();
-        delay(80);
     };
 
     /** ────────────────────────────────────────────────────────────────────────────
@@ -31,8 +36,11 @@ public:
         shift.setPin(controlPin, LOW);
         shift.setPin(reversePin, HIGH);
         shift.write();
-        delay(80);
     };
+
+    unsigned long settleTime() const override {
+        return 80;
+    }
 };
 
 class BallIntake : public Intake {
@@ -49,6 +49,16 @@ public:
     DS3232RTC rtc;
     std::function<void()> interruptCallback;
 
+    // Alarm 1 had fired when the RTC was set up: this boot is a scheduled wake up rather
+    // than a manual power on or a brown out
+    bool wokeByAlarm = false;
+
+private:
+    unsigned long shutdownPulseStart = 0;
+    bool shutdownPulse               = false;
+
+public:
+
     Power(const char * name) : KPComponent(name), rtc(false) {}
 
     void onInterrupt(std::function<void()> callbcak) {
@@ -60,6 +70,9 @@ public:
         waitForConnection();
         rtc.begin();
 
+        // Reading the flag clears it, which the reset below does anyway
+        wokeByAlarm = rtc.alarm(ALARM_1);
+
         // Reset RTC to a known state, clearing alarms, clear interrupts
         resetAlarms();
         rtc.squareWave(SQWAVE_NONE);
@@ -89,6 +102,11 @@ public:
 
      *  ──────────────────────────────────────────────────────────────────────────── */
     void update() override {
+        if (shutdownPulse && millis() - shutdownPulseStart >= 20) {
+            digitalWrite(HardwarePins::POWER_MODULE, LOW);
+            shutdownPulse = false;
+        }
+
         if (!alarmTriggered || !interruptCallback) {
             return;
         }
@@ -125,13 +143,22 @@ public:
     }
 
     /** ────────────────────────────────────────────────────────────────────────────
-     *  Signal the power module to cut power from the system
+     *  Signal the power module to cut power from the system. The 20 ms pulse ends in
+     *  update() so the caller keeps running until the power is actually gone.
      *
      *  ──────────────────────────────────────────────────────────────────────────── */
     void shutdown() {
+        if (shutdownPulse) {
+            return;
+        }
+
         digitalWrite(HardwarePins::POWER_MODULE, HIGH);
-        delay(20);
-        digitalWrite(HardwarePins::POWER_MODULE, LOW);
+        shutdownPulseStart = millis();
+        shutdownPulse      = true;
+    }
+
+    bool isShuttingDown() const {
+        return shutdownPulse;
     }
 
     /** ────────────────────────────────────────────────────────────────────────────
@@ -170,6 +197,9 @@ public:
         }
 
         LowPower.standby();
+
+        // SysTick stops in standby so the Time library clock is behind by the time asleep
+        setTime(rtc.get());
         println();
         println("Just woke up due to interrupt!");
         printCurrentTime();
@@ -186,16 +216,25 @@ public:
     }
 
     /** ────────────────────────────────────────────────────────────────────────────
-     *  Schedule alarm for specified number of seconds from now
+     *  Schedule alarm for specified number of seconds from now. The alarm matches the
+     *  day of month so it can be up to RTC_ALARM_MAX_DELAY ahead. Longer timeouts wake
+     *  up early and the wake up schedules the rest of the wait.
      *
      *  @param seconds How long until alarm
      *  @param usingInterrupt If true, the rtc fires interrupt at HardwarePins::RTC_INTERRUPT
      *  ──────────────────────────────────────────────────────────────────────────── */
     void setTimeout(unsigned long seconds, bool usingInterrupt) {
+        if (seconds > ProgramSettings::RTC_ALARM_MAX_DELAY) {
+            println(
+                "Alarm out of range, waking up in ", ProgramSettings::RTC_ALARM_MAX_DELAY,
+                " seconds to reschedule");
+            seconds = ProgramSettings::RTC_ALARM_MAX_DELAY;
+        }
+
         TimeElements future;
         breakTime(rtc.get() + seconds, future);
         disarmAlarms();
-        rtc.setAlarm(ALM1_MATCH_MINUTES, future.Second, future.Minute, future.Hour, 0);
+        rtc.setAlarm(ALM1_MATCH_DATE, future.Second, future.Minute, future.Hour, future.Day);
         if (usingInterrupt) {
             attachInterrupt(digitalPinToInterrupt(HardwarePins::RTC_INTERRUPT), rtc_isr, FALLING);
             rtc.alarmInterrupt(1, true);
@@ -0,0 +1,64 @@
+#pragma once
+#include <KPFoundation.hpp>
+
+#include <Components/Pump.hpp>
+#include <Components/SensorArrayObserver.hpp>
+#include <Utilities/PIController.hpp>
+
+//
+// ────────────────────────────────────────────────────────────────────────────── I ──────────
+//   :::::: P R E S S U R E   R E G U L A T O R : :  :   :    :     :        :          :
+// ────────────────────────────────────────────────────────────────────────────────────────
+//
+// Adjusts the pump duty on every pressure reading to hold the pressure at a target just
+// below the sample pressure limit. That keeps the most water going through the filter
+// without tripping the pressure stop. The loop runs at the rate of the pressure sensor,
+// which is raised for the duration of SAMPLE (see SampleTrace).
+//
+class PressureRegulator : public SensorArrayObserver {
+private:
+    Pump & pump;
+    PIController controller{0.1, 0.05, 0.25, 1};
+    bool active                   = false;
+    float target                  = 0;
+    unsigned long lastReadingTime = 0;
+
+public:
+    explicit PressureRegulator(Pump & pump) : pump(pump) {}
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Start regulating. The pump is expected to be running at full duty.
+     *
+     *  @param targetPressure Pressure to hold in psi
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void start(float targetPressure) {
+        target          = targetPressure;
+        lastReadingTime = millis();
+        controller.reset(1);
+        active = true;
+    }
+
+    void stop() {
+        active = false;
+    }
+
+    bool isActive() const {
+        return active;
+    }
+
+private:
+    const char * SensorManagerObserverName() const override {
+        return "PressureRegulator-SensorArray Observer";
+    }
+
+    void pressureSensorDidUpdate(PressureSensor::SensorData & values) override {
+        if (!active) {
+            return;
+        }
+
+        const unsigned long time = millis();
+        const float dt           = (time - lastReadingTime) / 1000.0;
+        lastReadingTime          = time;
+        pump.pwm(controller.update(target - std::get<0>(values), dt));
+    }
+};
@@ -7,6 +7,37 @@ public:
     const int control1;
     const int control2;
 
+    // Last output as analogWrite intensity (0-255) regardless of direction
+    uint8_t duty = 0;
+
+private:
+    bool pwmEnabled = false;
+
+    // Soft start in progress (see rampUp)
+    bool ramping                = false;
+    Direction rampDirection     = Direction::normal;
+    unsigned long rampStartTime = 0;
+    unsigned long rampDuration  = 0;
+
+    // analogWrite hands the pins to the timer. They must be switched back to GPIO before
+    // digitalWrite has any effect.
+    void disablePwm() {
+        if (pwmEnabled) {
+            pinMode(control1, OUTPUT);
+            pinMode(control2, OUTPUT);
+            pwmEnabled = false;
+        }
+    }
+
+    void write(float duty_cycle, Direction dir) {
+        uint8_t intensity = constrain(duty_cycle, 0, 1) * 255;
+        analogWrite(dir == Direction::normal ? control1 : control2, intensity);
+        analogWrite(dir == Direction::normal ? control2 : control1, 0);
+        duty       = intensity;
+        pwmEnabled = true;
+    }
+
+public:
     Pump(const char * name, int control1, int control2)
         : KPComponent(name),
           control1(control1),
@@ -17,20 +48,58 @@ public:
     }
 
     void on(Direction dir = Direction::normal) {
+        ramping = false;
+        disablePwm();
         digitalWrite(control1, dir == Direction::normal);
         digitalWrite(control2, dir != Direction::normal);
-        delay(20);
+        duty = 255;
     }
 
     void off() {
+        ramping = false;
+        disablePwm();
         digitalWrite(control1, 0);
         digitalWrite(control2, 0);
-        delay(20);
+        duty = 0;
     }
 
     void pwm(float duty_cycle, Direction dir = Direction::normal) {
-        uint8_t intensity = constrain(duty_cycle, 0, 1) * 255;
-        analogWrite(dir == Direction::normal ? control1 : control2, intensity);
-        analogWrite(dir == Direction::normal ? control2 : control1, 0);
+        ramping = false;
+        write(duty_cycle, dir);
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Soft start: ramp the duty linearly from 0 to full over the given time.
+     *  Runs from update(). Calling on(), off() or pwm() ends the ramp.
+     *
+     *  @param ms Duration of the ramp
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void rampUp(unsigned long ms, Direction dir = Direction::normal) {
+        if (ms == 0) {
+            return on(dir);
+        }
+
+        write(0, dir);
+        ramping       = true;
+        rampDirection = dir;
+        rampStartTime = millis();
+        rampDuration  = ms;
+    }
+
+    bool isRamping() const {
+        return ramping;
+    }
+
+    void update() override {
+        if (!ramping) {
+            return;
+        }
+
+        const unsigned long elapsed = millis() - rampStartTime;
+        if (elapsed >= rampDuration) {
+            on(rampDirection);
+        } else {
+            write(float(elapsed) / rampDuration, rampDirection);
+        }
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,181 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <SD.h>
+
+#include <Application/Constants.hpp>
+#include <Components/Pump.hpp>
+#include <Components/SensorArray.hpp>
+#include <Components/SensorArrayObserver.hpp>
+
+//
+// ────────────────────────────────────────────────────────────────── I ──────────
+//   :::::: S A M P L E   T R A C E : :  :   :    :     :        :          :
+// ────────────────────────────────────────────────────────────────────────────
+//
+// High rate capture of pressure, flow pulses and pump output during SAMPLE. Records go
+// into a preallocated buffer; taking one is a few stores so it costs next to nothing in
+// the main loop. The buffer must hold the entire sample, however long it runs, so when
+// it fills up every pair of records is merged into one and the period doubles. A long
+// sample therefore ends up at a lower rate instead of losing its beginning. Pressure and
+// pump output are averaged over the period of a record, so a lower rate smooths the
+// curve rather than skipping parts of it.
+//
+// Trace file layout (little endian): TraceHeader followed by `count` TraceRecord.
+//
+struct __attribute__((packed)) TraceRecord {
+    uint32_t time;        // Milliseconds since the start of the capture
+    uint16_t pressure;    // psi * 100, mean over the period
+    uint16_t flowPulses;  // Flow sensor pulses since the previous record
+    uint8_t pumpDuty;     // 0-255, mean over the period once decimated
+};
+
+struct __attribute__((packed)) TraceHeader {
+    char magic[4] = {'T', 'R', 'C', '1'};
+    uint32_t utc;
+    int32_t taskId;
+    int16_t valve;
+    uint16_t period;  // Milliseconds between records
+    uint16_t count;
+    uint8_t recordSize = sizeof(TraceRecord);
+};
+
+class SampleTrace : public KPComponent, public SensorArrayObserver {
+private:
+    SensorArray & sensors;
+    const Pump & pump;
+
+    TraceRecord records[ProgramSettings::TRACE_CAPACITY];
+    size_t count = 0;
+
+    bool capturing              = false;
+    unsigned long period        = 0;
+    unsigned long startTime     = 0;
+    unsigned long lastTime      = 0;
+    unsigned long lastFlowTicks = 0;
+    float pressure              = 0;
+    float pressureSum           = 0;  // Of the readings since the previous record
+    unsigned int pressureCount  = 0;
+    uint32_t startUtc           = 0;
+
+public:
+    SampleTrace(const char * name, SensorArray & sensors, const Pump & pump)
+        : KPComponent(name),
+          sensors(sensors),
+          pump(pump) {}
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Start a new capture. The pressure sensor is read at the trace rate until
+     *  stop() is called.
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void start() {
+        count         = 0;
+        period        = 1000 / ProgramSettings::TRACE_FREQ_HZ;
+        startTime     = millis();
+        lastTime      = startTime - period;
+        lastFlowTicks = flowTickCount;
+        pressureSum   = 0;
+        pressureCount = 0;
+        startUtc      = now();
+        capturing     = true;
+        sensors.pressure.setUpdateFreq(ProgramSettings::TRACE_FREQ_HZ);
+    }
+
+    void stop() {
+        if (capturing) {
+            capturing = false;
+            sensors.pressure.setUpdateFreq(PressureSensor::defaultFreqHz);
+        }
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Write the captured records to <folder>/<utc % 10^8>.trc
+     *
+     *  @param utc Time used to name the file. Should match the row in the sample log.
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void writeToFile(const char * folder, uint32_t utc, int taskId, int valve) {
+        if (count == 0) {
+            return;
+        }
+
+        if (!SD.exists(folder)) {
+            SD.mkdir(folder);
+        }
+
+        KPStringBuilder<32> filepath(folder, "/", utc % 100000000, ".trc");
+        SD.remove(filepath);
+        File file = SD.open(filepath, FILE_WRITE);
+        if (!file) {
+            println(RED("Unable to write "), filepath);
+            return;
+        }
+
+        TraceHeader header;
+        header.utc    = startUtc;
+        header.taskId = taskId;
+        header.valve  = valve;
+        header.period = period;
+        header.count  = count;
+        file.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const uint8_t *>(records), count * sizeof(TraceRecord));
+        file.close();
+        println("Trace: ", count, " records every ", period, " ms in ", filepath);
+    }
+
+    void update() override {
+        if (!capturing || millis() - lastTime < period) {
+            return;
+        }
+
+        if (count == ProgramSettings::TRACE_CAPACITY) {
+            decimate();
+        }
+
+        lastTime = millis();
+        noInterrupts();
+        const unsigned long ticks = flowTickCount;
+        interrupts();
+
+        const float average = pressureCount ? pressureSum / pressureCount : pressure;
+        pressureSum         = 0;
+        pressureCount       = 0;
+
+        TraceRecord & record = records[count++];
+        record.time          = lastTime - startTime;
+        record.pressure      = constrain(average * 100, 0, UINT16_MAX);
+        record.flowPulses    = std::min<unsigned long>(ticks - lastFlowTicks, UINT16_MAX);
+        record.pumpDuty      = pump.duty;
+        lastFlowTicks        = ticks;
+    }
+
+private:
+    // Merge every pair of records. Pulses add up, pressure and pump output are averaged
+    // and the time is taken from the later one.
+    void decimate() {
+        for (size_t i = 0; i < count / 2; i++) {
+            const TraceRecord & first  = records[2 * i];
+            const TraceRecord & second = records[2 * i + 1];
+            const uint32_t pulses      = first.flowPulses + second.flowPulses;
+            const uint16_t pressure    = (uint32_t(first.pressure) + second.pressure + 1) / 2;
+            const uint8_t duty         = (first.pumpDuty + second.pumpDuty + 1) / 2;
+
+            records[i]            = second;
+            records[i].flowPulses = std::min<uint32_t>(pulses, UINT16_MAX);
+            records[i].pressure   = pressure;
+            records[i].pumpDuty   = duty;
+        }
+
+        count /= 2;
+        period *= 2;
+    }
+
+    const char * SensorManagerObserverName() const override {
+        return "SampleTrace-SensorArray Observer";
+    }
+
+    void pressureSensorDidUpdate(PressureSensor::SensorData & values) override {
+        pressure = std::get<0>(values);
+        pressureSum += pressure;
+        pressureCount++;
+    }
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <functional>
+
+#include <Components/SensorArrayObserver.hpp>
+
+//
+// ──────────────────────────────────────────────────────────────────────── I ──────────
+//   :::::: S E N S O R   C O N D I T I O N : :  :   :    :     :        :          :
+// ──────────────────────────────────────────────────────────────────────────────────
+//
+// State condition that only depends on sensor readings. It is evaluated when the pressure
+// or flow sensor reports a new value instead of on every loop, and latches once true. The
+// state's own setCondition then only has to read the latch and check its deadline.
+//
+// Must be added to the sensor array after Status so that status.pressure is up to date
+// when the condition runs.
+//
+class SensorCondition : public SensorArrayObserver {
+private:
+    std::function<bool()> predicate;
+    bool triggered = false;
+
+public:
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Replace the condition. It is not evaluated until the next sensor update.
+     *
+     *  @param condition Returns true once the state should end
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void arm(std::function<bool()> condition) {
+        predicate = std::move(condition);
+        triggered = false;
+    }
+
+    void disarm() {
+        predicate = nullptr;
+        triggered = false;
+    }
+
+    bool isTriggered() const {
+        return triggered;
+    }
+
+private:
+    const char * SensorManagerObserverName() const override {
+        return "SensorCondition-SensorArray Observer";
+    }
+
+    void evaluate() {
+        if (predicate && !triggered) {
+            triggered = predicate();
+        }
+    }
+
+    void flowSensorDidUpdate(TurbineFlowSensor::SensorData & values) override {
+        evaluate();
+    }
+
+    void pressureSensorDidUpdate(PressureSensor::SensorData & values) override {
+        evaluate();
+    }
+};
@@ -7,7 +7,7 @@ private:
     SSC sensor;
 
     void begin() override {
-        setUpdateFreq(3);
+        setUpdateFreq(defaultFreqHz);
         sensor.setMinRaw(1638);
         sensor.setMaxRaw(14745);
         sensor.setMinPressure(0);
@@ -16,6 +16,8 @@ private:
     };
 
 public:
+    static constexpr double defaultFreqHz = 3;
+
     PressureSensor(int addr) : sensor(addr) {}
 
     SensorData read() override {
@@ -3,9 +3,11 @@
 volatile unsigned long lastFlowTick;
 volatile unsigned long flowIntervalMicros;
 volatile bool flowUpdated;
+volatile unsigned long flowTickCount;
 
 void flowTick() {
 	flowIntervalMicros = micros() - lastFlowTick;
 	lastFlowTick	   = micros();
 	flowUpdated		   = true;
+	flowTickCount++;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 extern volatile unsigned long lastFlowTick;
 extern volatile unsigned long flowIntervalMicros;
 extern volatile bool flowUpdated;
+extern volatile unsigned long flowTickCount;  // Total number of pulses, wraps around
 
 void flowTick();
 
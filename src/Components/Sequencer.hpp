@@ -0,0 +1,91 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <functional>
+#include <vector>
+
+//
+// ──────────────────────────────────────────────────────────── I ──────────
+//   :::::: S E Q U E N C E R : :  :   :    :     :        :          :
+// ──────────────────────────────────────────────────────────────────────
+//
+// Runs a list of timed actuation steps from update() instead of blocking the loop with
+// delay(). Steps run in order; wait() inserts a pause between two steps. A step with
+// nothing ahead of it runs right away, so the first steps of a state's enter() still
+// take effect immediately.
+//
+//     app.sequencer.clear()
+//         .then([&app]() { app.intake.on(); })
+//         .wait(app.intake.settleTime())
+//         .then([&app]() { app.pump.rampUp(500); });
+//
+class Sequencer : public KPComponent {
+private:
+    struct Step {
+        unsigned long delay;
+        std::function<void()> action;
+    };
+
+    std::vector<Step> steps;
+    size_t current             = 0;
+    unsigned long pendingDelay = 0;
+    unsigned long lastStepTime = 0;
+
+public:
+    using KPComponent::KPComponent;
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Drop the steps that have not run yet. States call this on enter so
+     *  that the rest of the previous sequence does not run in the new state.
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    Sequencer & clear() {
+        steps.clear();
+        current      = 0;
+        pendingDelay = 0;
+        return *this;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Pause before the next step
+     *
+     *  @param ms Milliseconds after the previous step
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    Sequencer & wait(unsigned long ms) {
+        if (isIdle()) {
+            // The pause starts now, not when the last step of an older sequence ran
+            lastStepTime = millis();
+        }
+
+        pendingDelay += ms;
+        return *this;
+    }
+
+    Sequencer & then(std::function<void()> action) {
+        if (isIdle()) {
+            steps.clear();
+            current = 0;
+            if (pendingDelay == 0) {
+                lastStepTime = millis();
+                action();
+                return *this;
+            }
+        }
+
+        steps.push_back({pendingDelay, std::move(action)});
+        pendingDelay = 0;
+        return *this;
+    }
+
+    bool isIdle() const {
+        return current == steps.size();
+    }
+
+    void update() override {
+        while (current < steps.size() && millis() - lastStepTime >= steps[current].delay) {
+            // Moved out first since the action may add or clear steps
+            auto action  = std::move(steps[current++].action);
+            lastStepTime = millis();
+            action();
+        }
+    }
+};
@@ -4,7 +4,79 @@
 #include <KPState.hpp>
 #include <type_traits>
 
-#define STATE(x) constexpr const char * x = #x "_STATE"
+//
+// ──────────────────────────────────────────────────────────── I ──────────
+//   :::::: S T A T E   G R A P H : :  :   :    :     :        :          :
+// ──────────────────────────────────────────────────────────────────────
+//
+// Each state controller declares its states as an enum of ids plus a constexpr table with
+// one node per id, in the same order. The table is a static member of a graph struct:
+//
+//     enum StateId : int { IDLE, FLUSH, STOP };
+//     struct Graph {
+//         static constexpr StateNode nodes[] = {
+//             STATE_NODE(IDLE, StateGraph::terminal),
+//             STATE_NODE(FLUSH, STOP),
+//             STATE_NODE(STOP, IDLE),
+//         };
+//     };
+//     static_assert(StateGraph::isValid(Graph::nodes), "...");
+//
+//     class Controller : public StateController<Graph> { ... };
+//
+// and defines it once in its .cpp (constexpr StateNode Graph::nodes[];) so every translation
+// unit shares one table and one controller base type.
+//
+// The table is checked at compile time and states are registered by id as a template
+// argument, so registering a state with or without a transition handler against what the
+// graph says fails to compile. The name of a state, as seen by KPStateMachine and in the
+// status, is generated from its id. KPStateMachine still owns the state objects and runs
+// the transitions by name; the table only sits in front of it.
+//
+#define STATE_NODE(id, next) \
+    { id, #id "_STATE", next }
+
+struct StateNode {
+    int id;
+    const char * name;
+    int next;  // Id of the state that follows, or one of StateGraph::terminal/handler
+};
+
+namespace StateGraph {
+    constexpr int terminal = -1;  // No next state (ex: IDLE)
+    constexpr int handler  = -2;  // Next state is chosen by the transition handler
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Every node is at the index of its id and leads to an existing state other
+     *  than itself, terminal or handler. At least one state is terminal so the machine
+     *  has somewhere to rest.
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    template <size_t N>
+    constexpr bool isValid(const StateNode (&graph)[N]) {
+        bool hasTerminal = false;
+        for (size_t i = 0; i < N; i++) {
+            const int next     = graph[i].next;
+            const bool special = next == terminal || next == handler;
+            if (graph[i].id != int(i) || !graph[i].name) {
+                return false;
+            }
+
+            if (!special && (next < 0 || next >= int(N) || next == int(i))) {
+                return false;
+            }
+
+            hasTerminal = hasTerminal || next == terminal;
+        }
+
+        return hasTerminal;
+    }
+
+    template <size_t N>
+    constexpr bool needsHandler(const StateNode (&graph)[N], int id) {
+        return id >= 0 && id < int(N) && graph[id].next == handler;
+    }
+}  // namespace StateGraph
 
 template <typename T>
 struct StateControllerConfig {
@@ -27,23 +99,108 @@ struct StateControllerConfig {
     }
 };
 
-class StateController : public KPStateMachine {
+template <typename Graph>
+class StateController : public KPStateMachine, public KPStateMachineObserver {
 private:
+    static constexpr size_t numberOfStates = std::extent<decltype(Graph::nodes)>::value;
+    static_assert(StateGraph::isValid(Graph::nodes), "Invalid state graph");
+
+    int currentId = noState;
+
     virtual void begin() = 0;
     virtual void stop()  = 0;
     virtual void idle()  = 0;
 
 public:
-    StateController(const char * name) : KPStateMachine(name) {}
+    explicit StateController(const char * name) : KPStateMachine(name) {
+        addObserver(this);
+    }
 
     virtual void setup() override {
         println("StateMachine Setup ");
     }
+
+    static constexpr int noState = -1;
+
+    const char * stateName(int id) const {
+        return Graph::nodes[id].name;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Id of the current state. Kept up to date on every transition.
+     *
+     *  @return int noState before the first transition
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    int currentStateId() const {
+        return currentId;
+    }
+
+    bool isInState(int id) const {
+        return currentId == id;
+    }
+
+protected:
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Register a state whose next state is given by the graph
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    template <int id, typename T>
+    void registerState(T && state) {
+        static_assert(id >= 0 && id < int(numberOfStates), "State id out of range");
+        static_assert(
+            !StateGraph::needsHandler(Graph::nodes, id), "State needs a transition handler");
+
+        const StateNode & node = Graph::nodes[id];
+        if (node.next == StateGraph::terminal) {
+            KPStateMachine::registerState(std::forward<T>(state), node.name);
+        } else {
+            KPStateMachine::registerState(
+                std::forward<T>(state), node.name, Graph::nodes[node.next].name);
+        }
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Register a state marked StateGraph::handler in the graph. The handler gets
+     *  the exit code of the state and calls transitionTo().
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    template <int id, typename T, typename Handler>
+    void registerState(T && state, Handler && handler) {
+        static_assert(StateGraph::needsHandler(Graph::nodes, id), "State has a fixed next state");
+        KPStateMachine::registerState(
+            std::forward<T>(state), Graph::nodes[id].name, std::forward<Handler>(handler));
+    }
+
+    template <typename T>
+    T & getState(int id) {
+        return KPStateMachine::getState<T>(Graph::nodes[id].name);
+    }
+
+    void transitionTo(int id) {
+        KPStateMachine::transitionTo(Graph::nodes[id].name);
+    }
+
+private:
+    const char * KPStateMachineObserverName() const override {
+        return "StateController-KPStateMachine Observer";
+    }
+
+    // Runs once per transition, including the ones made by KPStateMachine::next(). Names
+    // are compared by content since KPState may keep its own copy.
+    void stateDidBegin(const KPState * current) override {
+        currentId = noState;
+        for (size_t i = 0; i < numberOfStates; i++) {
+            if (strcmp(current->getName(), Graph::nodes[i].name) == 0) {
+                currentId = i;
+                break;
+            }
+        }
+    }
 };
 
-template <typename T>
-class StateControllerWithConfig : public StateController, public StateControllerConfig<T> {
+template <typename Graph, typename T>
+class StateControllerWithConfig : public StateController<Graph>, public StateControllerConfig<T> {
 public:
-    using StateController::StateController;
+    using StateController<Graph>::StateController;
     // using Configurator = StateControllerConfigurator<T>;
 };
\ No newline at end of file
@@ -0,0 +1,280 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <climits>
+#include <functional>
+
+#include <Application/Constants.hpp>
+
+//
+// ──────────────────────────────────────────────────────────────── I ──────────
+//   :::::: T I M E R   W H E E L : :  :   :    :     :        :          :
+// ──────────────────────────────────────────────────────────────────────────
+//
+// Every timed callback of the application runs from here. Timers live in a fixed pool and
+// hang in the slots of three wheels of 32 slots each:
+//
+//     level 0: one slot per tick (16 ms)     -> up to 0.5 s ahead
+//     level 1: one slot per 32 ticks          -> up to 16 s ahead
+//     level 2: one slot per 1024 ticks        -> up to 8.7 min ahead
+//
+// Scheduling and cancelling only link or unlink a node, so both are O(1). A timer drops to
+// a lower wheel each time the lower wheel wraps around, and fires from level 0 on its tick.
+// Deadlines past the last wheel wait in its farthest slot and are placed again from there.
+//
+// The wheel keeps its own tick counter, advanced by the milliseconds elapsed since the last
+// tick, so it keeps going when millis() wraps around after 49.7 days.
+//
+// Every callback records how late it ran after its deadline in a histogram (see Latency),
+// which shows how much idle sleep and busy states delay the loop.
+//
+// Handles carry the generation of their pool entry. A handle to a timer that has already
+// fired or was cancelled is stale and cancelling it does nothing.
+//
+class TimerWheel : public KPComponent {
+public:
+    struct Handle {
+        int16_t index       = -1;
+        uint16_t generation = 0;
+    };
+
+    static constexpr unsigned long noDeadline = ULONG_MAX;
+
+    // Bucket i counts callbacks that ran less than 2^i ms late; the last one holds the rest
+    struct Latency {
+        static constexpr int numberOfBuckets = 8;
+        unsigned long histogram[numberOfBuckets]{0};
+
+        void record(unsigned long latency) {
+            int bucket = 0;
+            while (bucket < numberOfBuckets - 1 && latency >= (1ul << bucket)) {
+                bucket++;
+            }
+
+            histogram[bucket]++;
+        }
+    };
+
+    Latency latency;
+
+private:
+    static constexpr unsigned long tickMs = 16;
+    static constexpr int slotBits         = 5;
+    static constexpr int slotsPerLevel    = 1 << slotBits;
+    static constexpr int levels           = 3;
+    static constexpr uint32_t maxTicks    = (1ul << (slotBits * levels)) - 1;
+
+    struct Timer {
+        std::function<void()> callback;
+        uint32_t expires     = 0;   // Tick
+        uint32_t periodTicks = 0;   // 0 for one-shot
+        uint16_t generation  = 0;
+        int16_t slot         = -1;  // -1 when free
+        int16_t previous     = -1;
+        int16_t next         = -1;
+    };
+
+    Timer timers[ProgramSettings::TIMER_CAPACITY];
+    int16_t slots[levels * slotsPerLevel];
+    uint32_t currentTick   = 0;
+    unsigned long tickTime = 0;  // millis() of the current tick
+
+public:
+    explicit TimerWheel(const char * name) : KPComponent(name) {
+        std::fill_n(slots, levels * slotsPerLevel, -1);
+    }
+
+    void setup() override {
+        tickTime = millis();
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Call back once after the delay, or every period if one is given
+     *
+     *  @param delay Milliseconds until the first call
+     *  @param callback Runs from update()
+     *  @param period Milliseconds between calls. 0 for a one-shot timer.
+     *  @return Handle Invalid (index -1) if the pool is full
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    Handle schedule(unsigned long delay, std::function<void()> callback, unsigned long period = 0) {
+        int16_t index = 0;
+        while (index < ProgramSettings::TIMER_CAPACITY && timers[index].slot != -1) {
+            index++;
+        }
+
+        if (index == ProgramSettings::TIMER_CAPACITY) {
+            println(RED("TimerWheel: no free timer"));
+            return Handle();
+        }
+
+        Timer & timer     = timers[index];
+        timer.callback    = std::move(callback);
+        timer.expires     = currentTick + (millis() - tickTime + delay + tickMs - 1) / tickMs;
+        timer.periodTicks = period ? std::max((period + tickMs / 2) / tickMs, 1ul) : 0;
+        add(index);
+        return Handle{index, timer.generation};
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Cancel the timer and invalidate the handle
+     *
+     *  @return true if the timer was still pending
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    bool cancel(Handle & handle) {
+        const bool pending = isPending(handle);
+        if (pending) {
+            unlink(handle.index);
+            release(handle.index);
+        }
+
+        handle = Handle();
+        return pending;
+    }
+
+    bool isPending(const Handle & handle) const {
+        return handle.index >= 0 && timers[handle.index].slot != -1
+               && timers[handle.index].generation == handle.generation;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Milliseconds until the earliest pending timer fires. Scans the pool, which
+     *  is small, rather than the wheels.
+     *
+     *  @return unsigned long 0 if a timer is due, noDeadline if there is none
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    unsigned long timeUntilNextDeadline() const {
+        const long sinceTick   = long(millis() - tickTime);
+        unsigned long earliest = noDeadline;
+        for (const Timer & timer : timers) {
+            if (timer.slot == -1) {
+                continue;
+            }
+
+            const int32_t ticksLeft = timer.expires - currentTick;
+            const long remaining    = std::max(long(ticksLeft) * long(tickMs) - sinceTick, 0l);
+            earliest                = std::min<unsigned long>(earliest, remaining);
+        }
+
+        return earliest;
+    }
+
+    void update() override {
+        // Elapsed time rather than absolute time, which wraps. The remainder of a tick
+        // carries over to the next update.
+        while (millis() - tickTime >= tickMs) {
+            tickTime += tickMs;
+            currentTick++;
+            cascade(1);
+            cascade(2);
+            expire(currentTick & (slotsPerLevel - 1));
+        }
+    }
+
+private:
+    // When the wheel below wraps around, the timers in the now current slot of this wheel
+    // are placed again, which moves them down.
+    void cascade(int level) {
+        const int shift = slotBits * level;
+        if ((currentTick & ((1ul << shift) - 1)) != 0) {
+            return;
+        }
+
+        const int slot = level * slotsPerLevel + ((currentTick >> shift) & (slotsPerLevel - 1));
+        int16_t index  = slots[slot];
+        slots[slot]    = -1;
+        while (index != -1) {
+            const int16_t next = timers[index].next;
+            add(index, currentTick);  // The current level 0 slot has not expired yet
+            index = next;
+        }
+    }
+
+    void expire(int slot) {
+        while (slots[slot] != -1) {
+            const int16_t index = slots[slot];
+            Timer & timer       = timers[index];
+            unlink(index);
+
+            // Ticks behind plus the time since the tick was due
+            const int32_t ticksLate = currentTick - timer.expires;
+            latency.record(std::max(ticksLate, int32_t(0)) * tickMs + (millis() - tickTime));
+
+            if (timer.periodTicks) {
+                // Keep the cadence unless we fell behind by more than one period
+                timer.expires += timer.periodTicks;
+                if (int32_t(timer.expires - currentTick) <= 0) {
+                    timer.expires = currentTick + timer.periodTicks;
+                }
+
+                add(index);
+
+                // Copied since the callback may cancel its own timer
+                auto callback = timer.callback;
+                callback();
+            } else {
+                // Released first so the callback may schedule into this entry
+                auto callback = std::move(timer.callback);
+                release(index);
+                callback();
+            }
+        }
+    }
+
+    // Timers due before earliestTick are placed on it. Outside of update() that is the next
+    // tick since the current one has already expired.
+    void add(int16_t index) {
+        add(index, currentTick + 1);
+    }
+
+    void add(int16_t index, uint32_t earliestTick) {
+        Timer & timer    = timers[index];
+        uint32_t expires = timer.expires;
+        if (int32_t(expires - earliestTick) < 0) {
+            expires = earliestTick;
+        }
+
+        const uint32_t ticks = std::min<uint32_t>(expires - currentTick, uint32_t(maxTicks));
+        int level            = 0;
+        while (level < levels - 1 && ticks >= (1ul << (slotBits * (level + 1)))) {
+            level++;
+        }
+
+        // Far deadlines sit in the farthest slot and get placed again when it comes up
+        const uint32_t slotTick = currentTick + ticks;
+        const int shift         = slotBits * level;
+        link(index, level * slotsPerLevel + ((slotTick >> shift) & (slotsPerLevel - 1)));
+    }
+
+    void link(int16_t index, int slot) {
+        Timer & timer  = timers[index];
+        timer.slot     = slot;
+        timer.previous = -1;
+        timer.next     = slots[slot];
+        if (timer.next != -1) {
+            timers[timer.next].previous = index;
+        }
+
+        slots[slot] = index;
+    }
+
+    void unlink(int16_t index) {
+        Timer & timer = timers[index];
+        if (timer.previous != -1) {
+            timers[timer.previous].next = timer.next;
+        } else {
+            slots[timer.slot] = timer.next;
+        }
+
+        if (timer.next != -1) {
+            timers[timer.next].previous = timer.previous;
+        }
+
+        timer.previous = timer.next = -1;
+    }
+
+    void release(int16_t index) {
+        Timer & timer  = timers[index];
+        timer.callback = nullptr;
+        timer.slot     = -1;
+        timer.generation++;
+    }
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <KPServer.hpp>
+#include <WiFi101.h>
+
+#include <Application/Constants.hpp>
+
+//
+// ────────────────────────────────────────────────────────────── I ──────────
+//   :::::: W I F I   C O N T R O L : :  :   :    :     :        :          :
+// ────────────────────────────────────────────────────────────────────────
+//
+// Brings the radio up only when someone may connect and powers it down again once nobody
+// has made a request for a while. The server is updated from here rather than added to the
+// controller, so it is never polled while the radio is off. Scheduled wakes never start the
+// radio and go straight to sampling.
+//
+// Started by: programming mode at boot, the button, or the "wifi" API route over serial.
+//
+class WiFiControl : public KPComponent {
+private:
+    KPServer & server;
+    bool started               = false;
+    unsigned long lastActivity = 0;
+
+public:
+    WiFiControl(const char * name, KPServer & server) : KPComponent(name), server(server) {}
+
+    void setup() override {
+        pinMode(HardwarePins::BUTTON_PIN, INPUT_PULLUP);
+    }
+
+    void start() {
+        if (started) {
+            return touch();
+        }
+
+        server.begin();
+        started = true;
+        touch();
+
+        if (server.enabled()) {
+            println();
+            println(BLUE("====================== WIFI ======================"));
+            server.printWiFiStatus();
+            println(BLUE("=================================================="));
+        }
+    }
+
+    void stop() {
+        if (started) {
+            WiFi.end();
+            started = false;
+            println("WiFi: off after ", ProgramSettings::WIFI_IDLE_TIMEOUT, " secs without request");
+        }
+    }
+
+    bool isStarted() const {
+        return started;
+    }
+
+    // Keeps the radio up. Requests do this through get() and post().
+    void touch() {
+        lastActivity = millis();
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Register a route on the server. Every request to it counts as activity,
+     *  so routes are registered here rather than on the server directly.
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    template <typename Handler>
+    void get(const char * path, Handler && handler) {
+        server.get(path, touching(std::forward<Handler>(handler)));
+    }
+
+    template <typename Handler>
+    void post(const char * path, Handler && handler) {
+        server.post(path, touching(std::forward<Handler>(handler)));
+    }
+
+    void update() override {
+        if (!started) {
+            if (digitalRead(HardwarePins::BUTTON_PIN) == LOW) {
+                start();
+            }
+
+            return;
+        }
+
+        server.update();
+        if (millis() - lastActivity >= secsToMillis(ProgramSettings::WIFI_IDLE_TIMEOUT)) {
+            stop();
+        }
+    }
+
+private:
+    template <typename Handler>
+    auto touching(Handler handler) {
+        return [this, handler](Request & req, Response & res) {
+            touch();
+            handler(req, res);
+        };
+    }
+};
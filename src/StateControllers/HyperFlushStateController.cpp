@@ -0,0 +1,4 @@
+#include <StateControllers/HyperFlushStateController.hpp>
+
+// Out of line definition of the graph (see Components/StateController.hpp)
+constexpr StateNode HyperFlush::Graph::nodes[];
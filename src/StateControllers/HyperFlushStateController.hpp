@@ -3,34 +3,50 @@
 #include <States/Shared.hpp>
 
 namespace HyperFlush {
-    STATE(IDLE);
-    STATE(STOP);
-    STATE(FLUSH);
-    STATE(OFFSHOOT_PRELOAD);
+    // FLUSH -> OFFSHOOT_PRELOAD -> STOP -> IDLE
+    enum StateId : int { FLUSH, OFFSHOOT_PRELOAD, STOP, IDLE };
+
+    struct Graph {
+        static constexpr StateNode nodes[] = {
+            STATE_NODE(FLUSH, OFFSHOOT_PRELOAD),
+            STATE_NODE(OFFSHOOT_PRELOAD, STOP),
+            STATE_NODE(STOP, IDLE),
+            STATE_NODE(IDLE, StateGraph::terminal),
+        };
+    };
+
+    static_assert(StateGraph::isValid(Graph::nodes), "HyperFlush: invalid state graph");
 
     struct Config {
-        decltype(SharedStates::Flush::time) flushTime;
+        decltype(SharedStates::FlushVolume::time) flushTime;
+        decltype(SharedStates::FlushVolume::volume) flushVolume;
         decltype(SharedStates::OffshootPreload::preloadTime) preloadTime;
+        decltype(SharedStates::OffshootPreload::preloadVolume) preloadVolume;
+        decltype(SharedStates::OffshootPreload::groupSize) preloadGroupSize;
+        decltype(SharedStates::OffshootPreload::pressureLimit) preloadPressureLimit;
     };
 
-    class Controller : public StateControllerWithConfig<Config> {
+    class Controller : public StateControllerWithConfig<Graph, Config> {
     public:
         Controller() : StateControllerWithConfig("hyperflush-state-machine") {}
 
-        // FLUSH -> OFFSHOOT_PRELOAD -> STOP -> IDLE
         void setup() override {
-            registerState(SharedStates::Flush(), FLUSH, OFFSHOOT_PRELOAD);
-            registerState(SharedStates::OffshootPreload(), OFFSHOOT_PRELOAD, STOP);
-            registerState(SharedStates::Stop(), STOP, IDLE);
-            registerState(SharedStates::Idle(), IDLE);
+            registerState<FLUSH>(SharedStates::FlushVolume());
+            registerState<OFFSHOOT_PRELOAD>(SharedStates::OffshootPreload());
+            registerState<STOP>(SharedStates::Stop());
+            registerState<IDLE>(SharedStates::Idle());
         }
 
         void begin() override {
-            decltype(auto) flush = getState<SharedStates::Flush>(FLUSH);
+            decltype(auto) flush = getState<SharedStates::FlushVolume>(FLUSH);
             flush.time           = config.flushTime;
+            flush.volume         = config.flushVolume;
 
             decltype(auto) preload = getState<SharedStates::OffshootPreload>(OFFSHOOT_PRELOAD);
             preload.preloadTime    = config.preloadTime;
+            preload.preloadVolume  = config.preloadVolume;
+            preload.groupSize      = config.preloadGroupSize;
+            preload.pressureLimit  = config.preloadPressureLimit;
 
             transitionTo(FLUSH);
         }
@@ -1,6 +1,9 @@
 #include <StateControllers/MainStateController.hpp>
 #include <Application/App.hpp>
 
+// Out of line definition of the graph (see Components/StateController.hpp)
+constexpr StateNode Main::Graph::nodes[];
+
 void Main::Idle::enter(KPStateMachine & sm) {
     auto & app = *static_cast<App *>(sm.controller);
     println(app.scheduleNextActiveTask().description());
@@ -8,9 +11,16 @@ void Main::Idle::enter(KPStateMachine & sm) {
 
 void Main::Stop::enter(KPStateMachine & sm) {
     auto & app = *static_cast<App *>(sm.controller);
+    app.loadDeferred();  // Everything is written back below
+    app.sequencer.clear();
+    app.sensorCondition.disarm();
+    app.timers.cancel(app.stateDeadline);
     app.pump.off();
     app.shift.writeAllRegistersLow();
     app.intake.off();
+    app.trace.stop();  // In case the sample was interrupted
+    app.pressureRegulator.stop();
+    app.sampleStatistics.stop(nullptr);
 
     app.vm.setValveStatus(app.status.currentValve, ValveStatus::sampled);
     app.vm.writeToDirectory();
@@ -3,12 +3,19 @@
 #include <States/Shared.hpp>
 
 namespace Main {
-    STATE(STOP);
-    STATE(IDLE);
-    STATE(PRESERVE);
-    STATE(DRY);
-    STATE(SAMPLE);
-    STATE(FLUSH);
+    // FLUSH -> SAMPLE -> STOP -> IDLE
+    enum StateId : int { FLUSH, SAMPLE, STOP, IDLE };
+
+    struct Graph {
+        static constexpr StateNode nodes[] = {
+            STATE_NODE(FLUSH, SAMPLE),
+            STATE_NODE(SAMPLE, STOP),
+            STATE_NODE(STOP, IDLE),
+            STATE_NODE(IDLE, StateGraph::terminal),
+        };
+    };
+
+    static_assert(StateGraph::isValid(Graph::nodes), "Main: invalid state graph");
 
     /**
      * This state checks if there is an active task and schedule it if any.
@@ -36,16 +43,15 @@ namespace Main {
         decltype(SharedStates::Sample::volume) sampleVolume;
     };
 
-    class Controller : public StateController, public StateControllerConfig<Config> {
+    class Controller : public StateController<Graph>, public StateControllerConfig<Config> {
     public:
         Controller() : StateController("main-state-machine") {}
 
-        // FLUSH -> SAMPLE -> DRY -> PRESERVE -> STOP -> IDLE
         void setup() override {
-            registerState(SharedStates::Flush(), FLUSH, SAMPLE);
-            registerState(SharedStates::Sample(), SAMPLE, STOP);
-            registerState(Stop(), STOP, IDLE);
-            registerState(Idle(), IDLE);
+            registerState<FLUSH>(SharedStates::Flush());
+            registerState<SAMPLE>(SharedStates::Sample());
+            registerState<STOP>(Stop());
+            registerState<IDLE>(Idle());
         }
 
         void begin() override {
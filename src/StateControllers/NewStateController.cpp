@@ -1,7 +1,11 @@
 #include <StateControllers/HyperFlushStateController.hpp>
 #include <Application/App.hpp>
+
+// Out of line definition of the graph (see Components/StateController.hpp)
+constexpr StateNode New::Graph::nodes[];
+
 void NewStateController::setup() {
-    // registerState(SharedStates::Flush(), FLUSH1, [this](int code) {
+    // registerState<FLUSH_1>(SharedStates::Flush(), [this](int code) {
     // 	switch (code) {
     // 	case 0:
     // 		return transitionTo(OFFSHOOT_CLEAN_1);
@@ -10,26 +14,42 @@ void NewStateController::setup() {
     // 	}
     // });
     // ..or alternatively if state only has one input and one output
+    // Next states are in the graph (see NewStateController.hpp)
 
-    registerState(SharedStates::Flush(), FLUSH_1, OFFSHOOT_CLEAN_1);
-    registerState(SharedStates::OffshootClean(5), OFFSHOOT_CLEAN_1, FLUSH_2);
-    registerState(SharedStates::Flush(), FLUSH_2, SAMPLE);
-    registerState(SharedStates::Sample(), SAMPLE, [this](int code) {
+    registerState<FLUSH_1>(SharedStates::FlushVolume());
+    registerState<OFFSHOOT_CLEAN_1>(SharedStates::OffshootClean(5));
+    registerState<FLUSH_2>(SharedStates::FlushVolume());
+    registerState<SAMPLE>(SharedStates::Sample(), [this](int code) {
         auto & app = *static_cast<App *>(controller);
         app.sensors.flow.stopMeasurement();
+        app.trace.stop();
+        app.pressureRegulator.stop();
+        app.sampleStatistics.stop(getState<SharedStates::Sample>(SAMPLE).condition);
+        app.vm.setValveSample(app.status.currentValve, app.sampleStatistics.summary);
         app.logAfterSample();
 
         switch (code) {
         case 0:
-            return transitionTo(OFFSHOOT_CLEAN_2);
+            return transitionTo(--batchRemaining > 0 ? BATCH_CLEAN : OFFSHOOT_CLEAN_2);
+        default:
+            halt(TRACE, "Unhandled state transition: ", code);
+        }
+    });
+    registerState<BATCH_CLEAN>(SharedStates::OffshootClean(5), [this](int code) {
+        auto & app = *static_cast<App *>(controller);
+        switch (code) {
+        case 0:
+            // The offshoot was just cleaned so skip OFFSHOOT_CLEAN_2 when the task has no
+            // valve left
+            return transitionTo(app.advanceBatch() ? SAMPLE : AIR_FLUSH);
         default:
             halt(TRACE, "Unhandled state transition: ", code);
         }
     });
-    registerState(SharedStates::OffshootClean(10), OFFSHOOT_CLEAN_2, AIR_FLUSH);
-    registerState(SharedStates::AirFlush(), AIR_FLUSH, STOP);
+    registerState<OFFSHOOT_CLEAN_2>(SharedStates::OffshootClean(10));
+    registerState<AIR_FLUSH>(SharedStates::AirFlush());
 
     // Reusing STOP and IDLE states from MainStateController
-    registerState(Main::Stop(), STOP, IDLE);
-    registerState(Main::Idle(), IDLE);
+    registerState<STOP>(Main::Stop());
+    registerState<IDLE>(Main::Idle());
 };
\ No newline at end of file
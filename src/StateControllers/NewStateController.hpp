@@ -4,45 +4,79 @@
 #include <StateControllers/MainStateController.hpp>
 
 namespace New {
-    STATE(IDLE);
-    STATE(FLUSH_1);
-    STATE(OFFSHOOT_CLEAN_1);
-    STATE(FLUSH_2);
-    STATE(SAMPLE);
-    STATE(OFFSHOOT_CLEAN_2);
-    STATE(DRY);
-    STATE(PRESERVE);
-    STATE(AIR_FLUSH);
-    STATE(STOP);
+    // FLUSH_1 -> OFFSHOOT_CLEAN_1 -> FLUSH_2 -> SAMPLE -> OFFSHOOT_CLEAN_2 -> AIR_FLUSH -> STOP
+    // In batch mode, SAMPLE -> BATCH_CLEAN -> SAMPLE on the next valve of the task until the
+    // batch is done. Valves and task are only written to the SD card in STOP.
+    enum StateId : int {
+        FLUSH_1,
+        OFFSHOOT_CLEAN_1,
+        FLUSH_2,
+        SAMPLE,
+        BATCH_CLEAN,
+        OFFSHOOT_CLEAN_2,
+        AIR_FLUSH,
+        STOP,
+        IDLE,
+    };
+
+    struct Graph {
+        static constexpr StateNode nodes[] = {
+            STATE_NODE(FLUSH_1, OFFSHOOT_CLEAN_1),
+            STATE_NODE(OFFSHOOT_CLEAN_1, FLUSH_2),
+            STATE_NODE(FLUSH_2, SAMPLE),
+            STATE_NODE(SAMPLE, StateGraph::handler),       // BATCH_CLEAN or OFFSHOOT_CLEAN_2
+            STATE_NODE(BATCH_CLEAN, StateGraph::handler),  // SAMPLE or AIR_FLUSH
+            STATE_NODE(OFFSHOOT_CLEAN_2, AIR_FLUSH),
+            STATE_NODE(AIR_FLUSH, STOP),
+            STATE_NODE(STOP, IDLE),
+            STATE_NODE(IDLE, StateGraph::terminal),
+        };
+    };
+
+    static_assert(StateGraph::isValid(Graph::nodes), "New: invalid state graph");
 
     struct Config {
-        decltype(SharedStates::Flush::time) flushTime;
+        decltype(SharedStates::FlushVolume::time) flushTime;
+        decltype(SharedStates::FlushVolume::volume) flushVolume;
         decltype(SharedStates::Sample::time) sampleTime;
         decltype(SharedStates::Sample::pressure) samplePressure;
         decltype(SharedStates::Sample::volume) sampleVolume;
+        decltype(SharedStates::Sample::clogRatio) sampleClogRatio;
+        decltype(SharedStates::Sample::clogWindow) sampleClogWindow;
+        decltype(SharedStates::Sample::pressureTarget) samplePressureTarget;
+        int batch;
     };
 
-    class Controller : public StateController, public StateControllerConfig<Config> {
+    class Controller : public StateController<Graph>, public StateControllerConfig<Config> {
+    private:
+        // Samples left in the current batch, including the one in progress
+        int batchRemaining = 0;
+
     public:
         Controller() : StateController("new-state-controller") {}
 
         void setup();
         void configureStates() {
-            decltype(auto) flush1 = getState<SharedStates::Flush>(FLUSH_1);
+            decltype(auto) flush1 = getState<SharedStates::FlushVolume>(FLUSH_1);
             flush1.time           = config.flushTime;
+            flush1.volume         = config.flushVolume;
 
-            decltype(auto) flush2 = getState<SharedStates::Flush>(FLUSH_2);
+            decltype(auto) flush2 = getState<SharedStates::FlushVolume>(FLUSH_2);
             flush2.time           = config.flushTime;
+            flush2.volume         = config.flushVolume;
 
             decltype(auto) sample = getState<SharedStates::Sample>(SAMPLE);
             sample.time           = config.sampleTime;
             sample.pressure       = config.samplePressure;
             sample.volume         = config.sampleVolume;
-
+            sample.clogRatio      = config.sampleClogRatio;
+            sample.clogWindow     = config.sampleClogWindow;
+            sample.pressureTarget = config.samplePressureTarget;
         }
 
         void begin() override {
             configureStates();
+            batchRemaining = max(config.batch, 1);
             transitionTo(FLUSH_1);
         }
 
@@ -55,7 +89,7 @@ namespace New {
         }
 
         bool isStop() {
-            return getCurrentState()->getName() == STOP;
+            return isInState(STOP);
         }
     };
 };  // namespace New
@@ -2,10 +2,30 @@
 #include <Application/App.hpp>
 
 namespace SharedStates {
+    namespace {
+        /** ────────────────────────────────────────────────────────────────────────────
+         *  @brief Move to the next state after the given time. Runs from the timer wheel
+         *  instead of a time condition polled on every loop. A deadline that fires after
+         *  the state was left some other way is ignored.
+         *
+         *  ──────────────────────────────────────────────────────────────────────────── */
+        void setDeadline(App & app, KPStateMachine & sm, const KPState & state, int seconds) {
+            app.timers.cancel(app.stateDeadline);
+            app.stateDeadline = app.timers.schedule(secsToMillis(seconds), [&sm, &state]() {
+                if (sm.getCurrentState() == &state) {
+                    sm.next();
+                }
+            });
+        }
+    }  // namespace
+
     void Idle::enter(KPStateMachine & sm) {}
 
     void Stop::enter(KPStateMachine & sm) {
         auto & app = *static_cast<App *>(sm.controller);
+        app.sequencer.clear();
+        app.sensorCondition.disarm();
+        app.timers.cancel(app.stateDeadline);
         app.pump.off();
         app.shift.writeAllRegistersLow();
         app.intake.off();
@@ -14,58 +34,102 @@ namespace SharedStates {
 
     void Flush::enter(KPStateMachine & sm) {
         auto & app = *static_cast<App *>(sm.controller);
-        app.shift.setAllRegistersLow();
-        app.intake.on();
-        app.shift.setPin(TPICDevices::FLUSH_VALVE, HIGH);
-        app.shift.write();
-        app.pump.on();
+        app.sequencer.clear()
+            .then([&app]() {
+                app.shift.setAllRegistersLow();
+                app.intake.on();
+            })
+            .wait(app.intake.settleTime())
+            .then([&app]() {
+                app.shift.setPin(TPICDevices::FLUSH_VALVE, HIGH);
+                app.shift.write();
+                app.pump.on();
+            });
 
         // To next state after 10 secs
-        setTimeCondition(time, [&]() { sm.next(); });
+        setDeadline(app, sm, *this, time);
     }
 
     void FlushVolume::enter(KPStateMachine & sm) {
         auto & app = *static_cast<App *>(sm.controller);
-        app.shift.setAllRegistersLow();
-        app.intake.on();
-        app.shift.setPin(TPICDevices::FLUSH_VALVE, HIGH);
-        app.shift.write();
-        app.pump.on();
+        app.sequencer.clear()
+            .then([&app]() {
+                app.shift.setAllRegistersLow();
+                app.intake.on();
+            })
+            .wait(app.intake.settleTime())
+            .then([&app]() {
+                app.shift.setPin(TPICDevices::FLUSH_VALVE, HIGH);
+                app.shift.write();
+                app.pump.on();
+            });
+
+        app.sensors.flow.resetVolume();
+        app.sensors.flow.startMeasurement();
+
+        // The volume is checked on flow updates only. Whichever comes first: volume or
+        // time. Only one of them may move the state machine forward.
+        app.sensorCondition.arm([&]() { return volume > 0 && app.sensors.flow.volume >= volume; });
+        auto condition = [&]() {
+            return app.sensorCondition.isTriggered()
+                   || timeSinceLastTransition() >= secsToMillis(time);
+        };
 
-        auto condition = [&]() { return app.status.waterVolume >= 500; };
-        setCondition(condition, [&]() { sm.next(1); });
-        setTimeCondition(time, [&]() { sm.next(); });
+        setCondition(condition, [&]() {
+            println("Flushed ", app.sensors.flow.volume, " in ", timeSinceLastTransition(), " ms");
+            app.sensorCondition.disarm();
+            app.sensors.flow.stopMeasurement();
+            sm.next();
+        });
     }
 
     void AirFlush::enter(KPStateMachine & sm) {
         auto & app = *static_cast<App *>(sm.controller);
+        app.sequencer.clear();
         app.shift.writeAllRegistersLow();
         app.shift.setPin(TPICDevices::AIR_VALVE, HIGH);
         app.shift.setPin(TPICDevices::FLUSH_VALVE, HIGH);
         app.shift.write();
         app.pump.on();
 
-        setTimeCondition(time, [&]() { sm.next(); });
+        setDeadline(app, sm, *this, time);
     }
 
     void Sample::enter(KPStateMachine & sm) {
-        // We set the latch valve to intake mode, turn on the filter valve, then the pump
+        // We set the latch valve to intake mode, turn on the filter valve, then soft start
+        // the pump. Pressure regulation takes over once the pump is up to speed.
         auto & app = *static_cast<App *>(sm.controller);
-        app.shift.setAllRegistersLow();
-        app.intake.on();
-        app.shift.setPin(app.currentValveIdToPin(), HIGH);
-        app.shift.write();
-        app.pump.on();
+        app.sequencer.clear()
+            .then([&app]() {
+                app.shift.setAllRegistersLow();
+                app.intake.on();
+            })
+            .wait(app.intake.settleTime())
+            .then([&app]() {
+                app.shift.setPin(app.currentValveIdToPin(), HIGH);
+                app.shift.write();
+                app.pump.rampUp(ProgramSettings::PUMP_RAMP_TIME);
+            });
+
+        if (pressureTarget > 0) {
+            const float target = pressure * min(pressureTarget, 1.0f);
+            app.sequencer.wait(ProgramSettings::PUMP_RAMP_TIME).then([&app, target]() {
+                app.pressureRegulator.start(target);
+            });
+        }
 
         app.sensors.flow.resetVolume();
         app.sensors.flow.startMeasurement();
+        app.trace.start();
+        app.sampleStatistics.start(pressure);
 
         app.status.maxPressure = 0;
         this->condition        = nullptr;
 
-        // This condition will be evaluated repeatedly until true then the callback will be executed
-        // once
-        auto const condition = [&]() {
+        // Volume, pressure and clog only change with the sensors so they are evaluated on
+        // sensor updates. The pressure sensor reports even when there is no flow at all,
+        // which keeps the clog windows going.
+        app.sensorCondition.arm([&]() {
             if (app.sensors.flow.volume >= volume) {
                 this->condition = "volume";
             }
@@ -74,70 +138,157 @@ namespace SharedStates {
                 this->condition = "pressure";
             }
 
-            if (timeSinceLastTransition() >= secsToMillis(time)) {
+            if (isClogged(app.sensors.flow.volume)) {
+                this->condition = "clog";
+            }
+
+            return this->condition != nullptr;
+        });
+
+        // Polled every loop: only reads the latch and the deadline
+        auto const condition = [&]() {
+            if (!app.sensorCondition.isTriggered()
+                && timeSinceLastTransition() >= secsToMillis(time)) {
                 this->condition = "time";
             }
 
             return this->condition != nullptr;
         };
 
-        setCondition(condition, [&]() { sm.next(); });
+        windowStartTime   = millis();
+        windowStartVolume = 0;
+        referenceFlow     = 0;
+        setCondition(condition, [&]() {
+            app.sensorCondition.disarm();
+            sm.next();
+        });
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief The flow rate is measured over consecutive windows from the volume
+     *  delta, so it costs nothing between windows and also catches a flow that stopped
+     *  completely (no more pulses, no more flow readings)
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    bool Sample::isClogged(float currentVolume) {
+        if (clogRatio <= 0 || clogWindow == 0) {
+            return false;
+        }
+
+        const unsigned long elapsed = millis() - windowStartTime;
+        if (elapsed < secsToMillis(clogWindow)) {
+            return false;
+        }
+
+        const float flow  = (currentVolume - windowStartVolume) / elapsed;
+        windowStartTime   = millis();
+        windowStartVolume = currentVolume;
+
+        // The first window only sets the reference since the flow is still ramping up
+        const bool hasReference = referenceFlow > 0;
+        referenceFlow           = max(referenceFlow, flow);
+        return hasReference && flow < clogRatio * referenceFlow;
     }
 
 
     void OffshootClean::enter(KPStateMachine & sm) {
         auto & app = *static_cast<App *>(sm.controller);
-        app.shift.setAllRegistersLow();  // Reset shift registers
-        app.intake.on();
-        app.shift.setPin(app.currentValveIdToPin(), HIGH);
-        app.shift.setPin(TPICDevices::FLUSH_VALVE, HIGH);
-        app.shift.write();
-        app.pump.on(Direction::reverse);
+        app.sequencer.clear()
+            .then([&app]() {
+                app.shift.setAllRegistersLow();  // Reset shift registers
+                app.intake.on();
+            })
+            .wait(app.intake.settleTime())
+            .then([&app]() {
+                app.shift.setPin(app.currentValveIdToPin(), HIGH);
+                app.shift.setPin(TPICDevices::FLUSH_VALVE, HIGH);
+                app.shift.write();
+                app.pump.on(Direction::reverse);
+            });
 
-        setTimeCondition(time, [&]() { sm.next(); });
+        setDeadline(app, sm, *this, time);
     };
 
     void OffshootPreload::enter(KPStateMachine & sm) {
         // Intake valve is opened and the motor is runnning ...
-        // Turnoff only the flush valve
+        // Turnoff only the flush valve. The first group opens once the intake has settled.
         auto & app = *static_cast<App *>(sm.controller);
-        app.shift.setPin(TPICDevices::FLUSH_VALVE, LOW);
-        app.intake.on();
+        app.sequencer.clear()
+            .then([&app]() {
+                app.shift.setPin(TPICDevices::FLUSH_VALVE, LOW);
+                app.intake.on();
+            })
+            .wait(app.intake.settleTime())
+            .then([&app]() { app.sensors.flow.startMeasurement(); });
+
+        println("Begin preloading procedure for ", app.vm.numberOfValvesInUse, " valves, ",
+                groupSize, " at a time...");
+
+        valveIndex       = 0;
+        openCount        = 0;
+        currentGroupSize = constrain(groupSize, 1, ProgramSettings::MAX_VALVES);
+
+        // Evaluated repeatedly: moves through the valve groups and is true after the last one
+        setCondition([&]() { return app.sequencer.isIdle() && step(app); }, [&]() {
+            app.sensors.flow.stopMeasurement();
+            sm.next();
+        });
+    };
 
-        // Reserving space ahead of time for performance
-        reserve(app.vm.numberOfValvesInUse + 1);
-        println("Begin preloading procedure for ", app.vm.numberOfValvesInUse, " valves...");
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Advance to the next group of available valves once the current one is
+     *  done. A group is done when it has taken in preloadVolume per offshoot or after
+     *  preloadTime, so preloading takes about 1/groupSize of the time of one by one.
+     *
+     *  @return true when every valve has been preloaded
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    bool OffshootPreload::step(App & app) {
+        if (openCount) {
+            groupMaxPressure         = max(groupMaxPressure, app.status.pressure);
+            const float groupVolume  = preloadVolume * openCount;
+            const bool volumeReached = preloadVolume > 0 && app.sensors.flow.volume >= groupVolume;
+            if (!volumeReached && millis() - groupStartTime < secsToMillis(preloadTime)) {
+                return false;
+            }
+
+            // Turn off the previous group
+            for (int i = 0; i < openCount; i++) {
+                app.shift.setPin(openPins[i], LOW);
+            }
 
-        int counter      = 0;
-        int prevValvePin = 0;
-        for (const decltype(auto) valve : app.vm.valves) {
+            println("done (", app.sensors.flow.volume, ")");
+            openCount = 0;
+
+            if (pressureLimit > 0 && groupMaxPressure > pressureLimit && currentGroupSize > 1) {
+                currentGroupSize /= 2;
+                println("Pressure ", groupMaxPressure, " over ", pressureLimit, ", preloading ",
+                        currentGroupSize, " at a time");
+            }
+        }
+
+        while (valveIndex < app.vm.valves.size() && openCount < currentGroupSize) {
+            const Valve & valve = app.vm.valves[valveIndex++];
             if (valve.status == ValveStatus::unavailable) {
                 continue;
             }
 
             // Skip the first register
-            auto valvePin = valve.id + app.shift.capacityPerRegister;
-            setTimeCondition(counter * preloadTime, [&app, prevValvePin, valvePin]() {
-                if (prevValvePin) {
-                    // Turn off the previous valve
-                    app.shift.setPin(prevValvePin, LOW);
-                    println("done");
-                }
-
-                app.shift.setPin(valvePin, HIGH);
-                app.shift.write();
-                print("Flushing offshoot ", valvePin - app.shift.capacityPerRegister, "...");
-            });
+            const int pin = valve.id + app.shift.capacityPerRegister;
+            app.shift.setPin(pin, HIGH);
+            openPins[openCount++] = pin;
+            print(openCount == 1 ? "Flushing offshoots " : ", ", valve.id);
+        }
 
-            prevValvePin = valvePin;
-            counter++;
+        app.shift.write();
+        if (openCount == 0) {
+            return true;
         }
 
-        // Transition to the next state after the last valve
-        setTimeCondition(counter * preloadTime, [&]() {
-            println("done");
-            sm.next();
-        });
-    };
+        app.sensors.flow.resetVolume();
+        groupStartTime   = millis();
+        groupMaxPressure = 0;
+        print("...");
+        return false;
+    }
 
 }  // namespace SharedStates
\ No newline at end of file
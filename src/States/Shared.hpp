@@ -1,5 +1,8 @@
 #pragma once
 #include <KPState.hpp>
+#include <Application/Constants.hpp>
+
+class App;
 
 namespace SharedStates {
     /** ────────────────────────────────────────────────────────────────────────────
@@ -33,13 +36,16 @@ namespace SharedStates {
     };
 
     /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Flush the main pipe until the flow sensor measured the given volume
+     *  [Connections: 1]
      *
-     *
+     *  @param volume Flush volume (same unit as the flow sensor). 0 flushes for time.
+     *  @param time Maximum flush time in seconds
      *  ──────────────────────────────────────────────────────────────────────────── */
     class FlushVolume : public KPState {
     public:
-        unsigned long time   = 10;
-        unsigned long volume = 1000;
+        unsigned long time = 10;
+        float volume       = 1;
         void enter(KPStateMachine & sm) override;
     };
 
@@ -63,8 +69,26 @@ namespace SharedStates {
         float pressure     = 8;
         float volume       = 1000;
 
+        // Clog detection: the sample ends with condition "clog" once the flow rate over the
+        // last clogWindow seconds drops below clogRatio times the best rate seen so far
+        // during this sample. Disabled when clogRatio is 0.
+        float clogRatio          = 0;
+        unsigned long clogWindow = 10;
+
+        // Pressure control: the pump duty is regulated to hold pressureTarget times the
+        // pressure limit. Disabled (full duty) when pressureTarget is 0.
+        float pressureTarget = 0;
+
         const char * condition;
 
+    private:
+        unsigned long windowStartTime = 0;
+        float windowStartVolume       = 0;
+        float referenceFlow           = 0;
+
+        bool isClogged(float currentVolume);
+
+    public:
         void enter(KPStateMachine & sm) override;
     };
 
@@ -82,13 +106,38 @@ namespace SharedStates {
     };
 
     /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Fill the offshoot of every available valve, groupSize valves at a time in
+     *  valve order. A group moves on once the flow sensor measured preloadVolume for each
+     *  of its valves or after preloadTime. If the pressure of a group went over
+     *  pressureLimit, the group size is halved (down to 1) for the rest of the preload.
+     *  [Connections: 1]
      *
-     *
+     *  @param preloadVolume Volume per valve (same unit as the flow sensor). 0 preloads
+     *  each group for preloadTime.
+     *  @param preloadTime Maximum time per group in seconds
+     *  @param groupSize Number of valves open at once
+     *  @param pressureLimit Pressure that halves the group size. 0 for no limit.
      *  ──────────────────────────────────────────────────────────────────────────── */
     class OffshootPreload : public KPState {
     public:
-        int preloadTime = 5;
+        int preloadTime     = 5;
+        float preloadVolume = 0;  // Per offshoot
+
+        // Number of offshoots preloaded at once. Halved for the rest of the preload
+        // whenever a group goes over the pressure limit (0 for no limit).
+        int groupSize       = 1;
+        float pressureLimit = 0;
         void enter(KPStateMachine & sm) override;
+
+    private:
+        size_t valveIndex                         = 0;
+        int openPins[ProgramSettings::MAX_VALVES] = {0};
+        int openCount                             = 0;
+        int currentGroupSize                      = 1;
+        unsigned long groupStartTime              = 0;
+        float groupMaxPressure                    = 0;
+
+        bool step(App & app);
     };
 
 }  // namespace SharedStates
@@ -34,6 +34,15 @@ public:
     float sampleVolume = 0;
     int samplePressure = 0;
 
+    float sampleClogRatio = 0;  // 0 disables clog detection
+    int sampleClogWindow  = 10;
+
+    float samplePressureTarget = 0;  // Fraction of samplePressure, 0 runs the pump at full duty
+
+    // Number of valves sampled back to back in one session, with only an offshoot clean in
+    // between. 1 runs the full cycle for every valve.
+    int batch = 1;
+
     bool deleteOnCompletion = false;
 
     std::vector<uint8_t> valves;
@@ -109,6 +118,12 @@ public:
         samplePressure = source[SAMPLE_PRESSURE];
         sampleVolume   = source[SAMPLE_VOLUME];
         timeBetween    = source[TIME_BETWEEN];
+
+        sampleClogRatio  = source[SAMPLE_CLOG_RATIO] | 0.0f;
+        sampleClogWindow = source[SAMPLE_CLOG_WINDOW] | 10;
+
+        samplePressureTarget = source[SAMPLE_PRESSURE_TARGET] | 0.0f;
+        batch                = source[BATCH] | 1;
     }
 #pragma endregion
 #pragma region JSONENCODABLE
@@ -135,6 +150,10 @@ public:
 			&& dst[SAMPLE_TIME].set(sampleTime)
 			&& dst[SAMPLE_PRESSURE].set(samplePressure) 
 			&& dst[SAMPLE_VOLUME].set(sampleVolume)
+			&& dst[SAMPLE_CLOG_RATIO].set(sampleClogRatio)
+			&& dst[SAMPLE_CLOG_WINDOW].set(sampleClogWindow)
+			&& dst[SAMPLE_PRESSURE_TARGET].set(samplePressureTarget)
+			&& dst[BATCH].set(batch)
 			&& dst[TIME_BETWEEN].set(timeBetween) 
 			&& dst[VALVES_OFFSET].set(getValveOffsetStart())
 			&& dst[DELETE].set(deleteOnCompletion)
@@ -150,9 +169,14 @@ public:
 #pragma endregion
 
     void operator()(NewStateController::Config & config) const {
-        config.flushTime      = flushTime;
-        config.sampleTime     = sampleTime;
-        config.samplePressure = samplePressure;
-        config.sampleVolume   = sampleVolume;
+        config.flushTime            = flushTime;
+        config.flushVolume          = flushVolume;
+        config.sampleTime           = sampleTime;
+        config.samplePressure       = samplePressure;
+        config.sampleVolume         = sampleVolume;
+        config.sampleClogRatio      = sampleClogRatio;
+        config.sampleClogWindow     = sampleClogWindow;
+        config.samplePressureTarget = samplePressureTarget;
+        config.batch                = batch;
     }
 };
\ No newline at end of file
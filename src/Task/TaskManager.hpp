@@ -98,6 +98,21 @@ public:
         return tasks.find(id) != tasks.end();
     }
 
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Find the id of the first task with the given name
+     *
+     *  @return int 0 if there is no such task
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    int findTaskIdByName(const char * name) const {
+        for (const auto & kv : tasks) {
+            if (strcmp(kv.second.name, name) == 0) {
+                return kv.first;
+            }
+        }
+
+        return 0;
+    }
+
     bool deleteTask(int id) {
         if (tasks.erase(id)) {
             updateObservers(&TaskObserver::taskDidDelete, id);
@@ -152,6 +167,30 @@ public:
         // updateObservers(&TaskObserver::taskCollectionDidUpdate, tasks.begin());
     }
 
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Load a single task file, ex: the next task from the resume record. Tasks
+     *  already in memory are kept by loadTasksFromDirectory() if it runs later.
+     *
+     *  @param index Number of the file: <dir>/task-<index>.js
+     *  @param id Id the task in the file must have
+     *  @return true if the file holds that task
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    bool loadTaskFile(int index, int id, const char * _dir = nullptr) {
+        const char * dir = _dir ? _dir : taskFolder;
+        KPStringBuilder<32> filepath(dir, "/task-", index, ".js");
+
+        Task task;
+        task.id = 0;
+        JsonFileLoader loader;
+        loader.load(filepath, task);
+        if (task.id != id) {
+            return false;
+        }
+
+        tasks.insert({task.id, task});
+        return true;
+    }
+
     /** ────────────────────────────────────────────────────────────────────────────
      *  @brief Get the Active Task Ids sorted by their schedules (<)
      *
@@ -252,6 +291,46 @@ public:
 
         return true;
     }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Measure the task array as it would be written by printJsonArray()
+     *
+     *  @param scratch Document reused for each task. Needs to fit a single task only.
+     *  @return size_t Number of characters of the serialized array
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    size_t measureJsonArray(JsonDocument & scratch) const {
+        size_t length = 2 + (tasks.empty() ? 0 : tasks.size() - 1);  // brackets and commas
+        for (const auto & kv : tasks) {
+            scratch.clear();
+            kv.second.encodeJSON(scratch.to<JsonVariant>());
+            length += measureJson(scratch);
+        }
+
+        return length;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Serialize the task array one task at a time. Memory usage is bounded
+     *  by a single task regardless of how many tasks there are.
+     *
+     *  @param printer Destination of the serialized array
+     *  @param scratch Document reused for each task. Needs to fit a single task only.
+     *  @return size_t Number of characters written
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    size_t printJsonArray(Print & printer, JsonDocument & scratch) const {
+        size_t charWritten = printer.print('[');
+        for (auto it = tasks.begin(); it != tasks.end(); it++) {
+            if (it != tasks.begin()) {
+                charWritten += printer.print(',');
+            }
+
+            scratch.clear();
+            it->second.encodeJSON(scratch.to<JsonVariant>());
+            charWritten += serializeJson(scratch, printer);
+        }
+
+        return charWritten + printer.print(']');
+    }
 #pragma endregion
 #pragma region PRINTABLE
     size_t printTo(Print & p) const {
@@ -0,0 +1,87 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <SD.h>
+
+#include <Application/Constants.hpp>
+
+//
+// ──────────────────────────────────────────────────────────────── I ──────────
+//   :::::: B O O T   T I M E L I N E : :  :   :    :     :        :          :
+// ──────────────────────────────────────────────────────────────────────────
+//
+// Where the boot spends its time. setup() marks the end of each phase with micros(); a
+// phase starts where the previous one ended and the first one at reset. The timeline is
+// appended to boot.csv on every full boot, one row per phase, and is served with the idle
+// statistics by /api/metrics.
+//
+// Phases marked as waiting (ex: for the serial monitor in DEBUG builds) are reported but
+// left out of cost(), which is what a boot costs on an unattended unit.
+//
+struct BootPhase {
+    const char * name;  // Must outlive the timeline (string literals)
+    uint32_t end;       // Microseconds since reset
+    bool waiting;
+};
+
+class BootTimeline {
+private:
+    BootPhase phases[ProgramSettings::BOOT_TIMELINE_CAPACITY];
+    size_t count = 0;
+
+public:
+    void mark(const char * name, bool waiting = false) {
+        if (count < ProgramSettings::BOOT_TIMELINE_CAPACITY) {
+            phases[count++] = {name, uint32_t(micros()), waiting};
+        }
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    const BootPhase & operator[](size_t index) const {
+        return phases[index];
+    }
+
+    uint32_t startOf(size_t index) const {
+        return index == 0 ? 0 : phases[index - 1].end;
+    }
+
+    uint32_t durationOf(size_t index) const {
+        return phases[index].end - startOf(index);
+    }
+
+    uint32_t total() const {
+        return count ? phases[count - 1].end : 0;
+    }
+
+    // Microseconds of the boot itself, without the waiting phases
+    uint32_t cost() const {
+        uint32_t waited = 0;
+        for (size_t i = 0; i < count; i++) {
+            waited += phases[i].waiting ? durationOf(i) : 0;
+        }
+
+        return total() - waited;
+    }
+
+    void appendToFile(const char * path, uint32_t utc) const {
+        const bool exists = SD.exists(path);
+        File file         = SD.open(path, FILE_WRITE);
+        if (!file) {
+            println(RED("Unable to write "), path);
+            return;
+        }
+
+        if (!exists) {
+            file.println("UTC, Phase, Start (us), Duration (us)");
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            KPStringBuilder<80> row{utc, ",", phases[i].name, ",", startOf(i), ",", durationOf(i)};
+            file.println(row);
+        }
+
+        file.close();
+    }
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+//
+// ──────────────────────────────────────────────────────── I ──────────
+//   :::::: F R A M I N G : :  :   :    :     :        :          :
+// ──────────────────────────────────────────────────────────────────
+//
+// COBS (Consistent Overhead Byte Stuffing) and CRC-16/CCITT-FALSE used by the binary
+// serial protocol. COBS removes every zero byte from the frame so that a single zero can
+// mark the end of each frame, which lets the receiver resynchronize after garbage.
+// See: https://en.wikipedia.org/wiki/Consistent_Overhead_Byte_Stuffing
+//
+namespace Framing {
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Worst case size of the COBS encoding of length bytes (without delimiter)
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    constexpr size_t encodedSize(size_t length) {
+        return length + length / 254 + 1;
+    }
+
+    inline uint16_t crc16(const uint8_t * data, size_t length, uint16_t crc = 0xFFFF) {
+        for (size_t i = 0; i < length; i++) {
+            crc ^= uint16_t(data[i]) << 8;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+            }
+        }
+
+        return crc;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief COBS encode
+     *
+     *  @param src Input bytes
+     *  @param length Number of input bytes
+     *  @param dst Output buffer of at least encodedSize(length) bytes
+     *  @return size_t Number of bytes written to dst
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    inline size_t cobsEncode(const uint8_t * src, size_t length, uint8_t * dst) {
+        size_t write = 1, code = 0;
+        uint8_t distance = 1;
+        for (size_t read = 0; read < length; read++) {
+            if (src[read] == 0) {
+                dst[code] = distance;
+                code      = write++;
+                distance  = 1;
+                continue;
+            }
+
+            dst[write++] = src[read];
+            if (++distance == 0xFF) {
+                dst[code] = distance;
+                code      = write++;
+                distance  = 1;
+            }
+        }
+
+        dst[code] = distance;
+        return write;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief COBS decode. Decoding in place (src == dst) is allowed.
+     *
+     *  @param src Encoded bytes without the zero delimiter
+     *  @param length Number of encoded bytes
+     *  @param dst Output buffer of at least length bytes
+     *  @return size_t Number of decoded bytes or 0 if the input is malformed
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    inline size_t cobsDecode(const uint8_t * src, size_t length, uint8_t * dst) {
+        size_t read = 0, write = 0;
+        while (read < length) {
+            const uint8_t code = src[read++];
+            if (code == 0 || read + code - 1 > length) {
+                return 0;
+            }
+
+            for (uint8_t i = 1; i < code; i++) {
+                dst[write++] = src[read++];
+            }
+
+            if (code != 0xFF && read != length) {
+                dst[write++] = 0;
+            }
+        }
+
+        return write;
+    }
+}  // namespace Framing
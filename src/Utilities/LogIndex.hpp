@@ -0,0 +1,296 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <SD.h>
+
+#include <Application/Constants.hpp>
+
+//
+// ────────────────────────────────────────────────────────── I ──────────
+//   :::::: L O G   I N D E X : :  :   :    :     :        :          :
+// ────────────────────────────────────────────────────────────────────
+//
+// Sparse index written alongside an append-only CSV log (ex: detail.csv -> detail.idx).
+// Each fixed-size entry maps the utc, task id and valve of a row to its byte offset in
+// the log. An entry is appended every `interval` rows and whenever the task or the valve
+// changes, so every row between two consecutive entries belongs to the task and valve of
+// the first one. That makes per task or per valve lookups exact without reading the log.
+//
+// Rows are appended in time order so the entries are sorted by utc and can be binary
+// searched directly on the SD card.
+//
+struct LogIndexEntry {
+    uint32_t utc;
+    uint32_t offset;
+    int32_t taskId;
+    int16_t valve;
+    uint16_t reserved;
+};
+
+static_assert(sizeof(LogIndexEntry) == 16, "Index entries are stored as is on the SD card");
+
+// Selects log rows by task and/or valve. -1 matches anything.
+struct LogIndexFilter {
+    int32_t taskId = -1;
+    int16_t valve  = -1;
+
+    bool isEmpty() const {
+        return taskId == -1 && valve == -1;
+    }
+
+    bool matches(const LogIndexEntry & entry) const {
+        return (taskId == -1 || entry.taskId == taskId) && (valve == -1 || entry.valve == valve);
+    }
+};
+
+class LogIndex {
+private:
+    char logPath[ProgramSettings::SD_FILE_NAME_LENGTH]{0};
+    char indexPath[ProgramSettings::SD_FILE_NAME_LENGTH]{0};
+    unsigned int interval = 1;
+    unsigned int counter  = 0;
+    int32_t lastTaskId    = -1;
+    int16_t lastValve     = -1;
+
+public:
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Initialize the index for the given log file
+     *
+     *  @param log Path to the log file. The index uses the same name with .idx
+     *  @param rowsPerEntry Maximum number of log rows per index entry
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void init(const char * log, unsigned int rowsPerEntry) {
+        strncpy(logPath, log, sizeof(logPath) - 1);
+        strncpy(indexPath, log, sizeof(indexPath) - 1);
+        char * extension = strrchr(indexPath, '.');
+        if (!extension || indexPath + sizeof(indexPath) - extension < 5) {
+            extension = indexPath + std::min(strlen(indexPath), sizeof(indexPath) - 5);
+        }
+
+        strcpy(extension, ".idx");
+        interval = std::max(rowsPerEntry, 1u);
+        reset();
+    }
+
+    const char * log() const {
+        return logPath;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Whether the index needs to be rebuilt: the index is missing, does not
+     *  consist of whole entries, or does not belong to the log as it is now. The last
+     *  entry must point at the start of a row with its utc, otherwise the log was
+     *  truncated or recreated after the index was written. An index left behind by a
+     *  deleted log is rebuilt empty.
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    bool needsRebuild() const {
+        File log = SD.open(logPath, FILE_READ);
+        if (!log) {
+            return SD.exists(indexPath);
+        }
+
+        File index   = SD.open(indexPath, FILE_READ);
+        bool invalid = !index || index.size() % sizeof(LogIndexEntry) != 0;
+        if (!invalid && index.size() > 0) {
+            LogIndexEntry last;
+            read(index, index.size() / sizeof(LogIndexEntry) - 1, last);
+            invalid = last.offset >= log.size() || utcOfRowAt(log, last.offset) != last.utc;
+        }
+
+        if (index) {
+            index.close();
+        }
+
+        log.close();
+        return invalid;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Call before appending a row to the log
+     *
+     *  @param utc Timestamp of the row
+     *  @param offset Current size of the log, i.e. where the row is going to start
+     *  @param taskId Id of the task the row belongs to (0 if none)
+     *  @param valve Valve of the row
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void rowWillAppend(uint32_t utc, uint32_t offset, int32_t taskId, int16_t valve) {
+        // Most rows are not indexed. Only touch the card for those that are.
+        if (!startsEntry(taskId, valve)) {
+            return;
+        }
+
+        File index = SD.open(indexPath, FILE_WRITE);
+        append(index, utc, offset, taskId, valve);
+        index.close();
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Rebuild the index by reading the whole log. Rows are expected to start
+     *  with "utc, formatted time, task name, valve number, ..."
+     *
+     *  @param resolveTaskId Returns the task id of a task name (0 if unknown)
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    template <typename Resolver>
+    void rebuild(Resolver && resolveTaskId) {
+        println("Rebuilding ", indexPath);
+        SD.remove(indexPath);
+        reset();
+
+        File log   = SD.open(logPath, FILE_READ);
+        File index = SD.open(indexPath, FILE_WRITE);
+
+        char row[256];
+        uint32_t offset = 0;
+        while (log.available()) {
+            // Read one line. Anything past the end of the buffer is skipped.
+            size_t length = 0, rowLength = 0;
+            int c;
+            while ((c = log.read()) >= 0) {
+                length++;
+                if (c == '\n') {
+                    break;
+                }
+
+                if (rowLength < sizeof(row) - 1) {
+                    row[rowLength++] = c;
+                }
+            }
+
+            row[rowLength] = 0;
+
+            char * column      = row;
+            const uint32_t utc = strtoul(strsep(&column, ","), nullptr, 10);
+            strsep(&column, ",");  // Formatted time
+            const char * taskName = strsep(&column, ",");
+            const char * valve    = strsep(&column, ",");
+
+            // The header row has no utc
+            if (utc && taskName && valve) {
+                const int32_t taskId      = resolveTaskId(taskName);
+                const int16_t valveNumber = atoi(valve);
+                if (startsEntry(taskId, valveNumber)) {
+                    append(index, utc, offset, taskId, valveNumber);
+                }
+            }
+
+            offset += length;
+        }
+
+        index.close();
+        log.close();
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Offset of the last indexed row at or before utc. Reading the log from
+     *  there and skipping rows older than utc yields every row from utc onward.
+     *
+     *  @return uint32_t 0 if no indexed row is old enough
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    uint32_t offsetAtOrBefore(uint32_t utc) const {
+        File file             = SD.open(indexPath, FILE_READ);
+        const int32_t entries = file ? file.size() / sizeof(LogIndexEntry) : 0;
+
+        // Find the first entry with entry.utc > utc. The one before it is the answer.
+        int32_t low = 0, high = entries;
+        LogIndexEntry entry;
+        while (low < high) {
+            const int32_t mid = (low + high) / 2;
+            read(file, mid, entry);
+            if (entry.utc <= utc) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        uint32_t offset = 0;
+        if (low > 0) {
+            read(file, low - 1, entry);
+            offset = entry.offset;
+        }
+
+        file.close();
+        return offset;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Call back with each [begin, end) byte range of the log whose rows match
+     *  the filter. Adjacent matching entries are merged into one range. The end of the
+     *  last range is UINT32_MAX when it extends to the end of the log.
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    template <typename Callback>
+    void forEachRange(const LogIndexFilter & filter, Callback && callback) const {
+        File file = SD.open(indexPath, FILE_READ);
+        if (!file) {
+            return;
+        }
+
+        const int32_t entries = file.size() / sizeof(LogIndexEntry);
+        bool matching         = false;
+        uint32_t begin        = 0;
+        LogIndexEntry entry;
+        for (int32_t i = 0; i < entries; i++) {
+            file.read(reinterpret_cast<uint8_t *>(&entry), sizeof(entry));
+            const bool match = filter.matches(entry);
+            if (match && !matching) {
+                begin = entry.offset;
+            } else if (!match && matching) {
+                callback(begin, entry.offset);
+            }
+
+            matching = match;
+        }
+
+        file.close();
+        if (matching) {
+            callback(begin, UINT32_MAX);
+        }
+    }
+
+private:
+    void reset() {
+        counter    = 0;
+        lastTaskId = -1;
+        lastValve  = -1;
+    }
+
+    // Counts the row. True if it gets an entry: every interval rows or on a new task or valve.
+    bool startsEntry(int32_t taskId, int16_t valve) {
+        const bool changed = taskId != lastTaskId || valve != lastValve;
+        return counter++ % interval == 0 || changed;
+    }
+
+    void append(File & index, uint32_t utc, uint32_t offset, int32_t taskId, int16_t valve) {
+        LogIndexEntry entry{utc, offset, taskId, valve, 0};
+        index.write(reinterpret_cast<const uint8_t *>(&entry), sizeof(entry));
+        lastTaskId = taskId;
+        lastValve  = valve;
+        counter    = 1;
+    }
+
+    static void read(File & file, int32_t index, LogIndexEntry & entry) {
+        file.seek(index * sizeof(LogIndexEntry));
+        file.read(reinterpret_cast<uint8_t *>(&entry), sizeof(entry));
+    }
+
+    // Leading utc of the row starting at offset. 0 if offset is not the start of a row.
+    static uint32_t utcOfRowAt(File & log, uint32_t offset) {
+        if (offset > 0) {
+            log.seek(offset - 1);
+            if (log.read() != '\n') {
+                return 0;
+            }
+        }
+
+        char digits[11];
+        size_t length = 0;
+        int c;
+        while (length < sizeof(digits) - 1 && (c = log.read()) >= '0' && c <= '9') {
+            digits[length++] = c;
+        }
+
+        digits[length] = 0;
+        return strtoul(digits, nullptr, 10);
+    }
+};
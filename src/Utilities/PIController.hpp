@@ -0,0 +1,65 @@
+#pragma once
+
+// ────────────────────────────────────────────────────────────────────────────────
+// Proportional-integral controller with output limits. The integral term stops
+// accumulating while the output is saturated in the direction of the error (clamping
+// anti-windup) so the controller recovers right away once the error changes sign.
+// ────────────────────────────────────────────────────────────────────────────────
+class PIController {
+public:
+    float kp;
+    float ki;
+    float outputMin;
+    float outputMax;
+
+private:
+    float integral = 0;
+
+public:
+    PIController(float kp, float ki, float outputMin, float outputMax)
+        : kp(kp),
+          ki(ki),
+          outputMin(outputMin),
+          outputMax(outputMax) {}
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Reset the controller so that it starts from the given output
+     *  (bumpless transfer from manual control)
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void reset(float output) {
+        integral = output;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Compute the next output
+     *
+     *  @param error Setpoint minus measurement
+     *  @param dt Seconds since the previous update
+     *  @return float Output within [outputMin, outputMax]
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    float update(float error, float dt) {
+        const float proportional = kp * error;
+        const float candidate    = integral + ki * error * dt;
+        const float output       = proportional + candidate;
+
+        if (output > outputMax) {
+            if (error < 0) {
+                integral = candidate;
+            }
+
+            return outputMax;
+        }
+
+        if (output < outputMin) {
+            if (error > 0) {
+                integral = candidate;
+            }
+
+            return outputMin;
+        }
+
+        integral = candidate;
+        return output;
+    }
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <KPFoundation.hpp>
+#include <KPServer.hpp>
+
+// ────────────────────────────────────────────────────────────────────────────────
+// Print adapter that collects small writes into a fixed buffer before handing them to
+// the HTTP response. ArduinoJson serializes one character at a time and sending each
+// of them separately would cost one WINC1500 socket write per character.
+// ────────────────────────────────────────────────────────────────────────────────
+template <size_t size>
+class ResponsePrinter : public Print {
+private:
+    Response & response;
+    char buffer[size + 1]{0};
+    size_t length = 0;
+
+public:
+    explicit ResponsePrinter(Response & response) : response(response) {}
+
+    ~ResponsePrinter() {
+        sendBuffer();
+    }
+
+    size_t write(uint8_t c) override {
+        buffer[length++] = c;
+        if (length == size) {
+            sendBuffer();
+        }
+
+        return 1;
+    }
+
+    /** ────────────────────────────────────────────────────────────────────────────
+     *  @brief Send whatever is left in the buffer to the client
+     *
+     *  ──────────────────────────────────────────────────────────────────────────── */
+    void sendBuffer() {
+        if (length == 0) {
+            return;
+        }
+
+        buffer[length] = 0;
+        response.send(buffer);
+        length = 0;
+    }
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <float.h>
+
+// ────────────────────────────────────────────────────────────────────────────────
+// Mean, variance, min and max of a stream of values in constant memory using Welford's
+// online algorithm, which stays accurate where the naive sum of squares would cancel.
+// See: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Welford's_online_algorithm
+// ────────────────────────────────────────────────────────────────────────────────
+class RunningStatistics {
+private:
+    unsigned long n = 0;
+    double m        = 0;
+    double m2       = 0;
+    float lowest    = FLT_MAX;
+    float highest   = -FLT_MAX;
+
+public:
+    void reset() {
+        *this = RunningStatistics();
+    }
+
+    void add(float value) {
+        n++;
+        const double delta = value - m;
+        m += delta / n;
+        m2 += delta * (value - m);
+        lowest  = value < lowest ? value : lowest;
+        highest = value > highest ? value : highest;
+    }
+
+    unsigned long count() const {
+        return n;
+    }
+
+    float mean() const {
+        return m;
+    }
+
+    // Sample variance (n - 1)
+    float variance() const {
+        return n > 1 ? m2 / (n - 1) : 0;
+    }
+
+    float minimum() const {
+        return n ? lowest : 0;
+    }
+
+    float maximum() const {
+        return n ? highest : 0;
+    }
+};
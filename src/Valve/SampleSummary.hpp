@@ -0,0 +1,66 @@
+#pragma once
+#include <KPFoundation.hpp>
+
+#include <ArduinoJson.h>
+#include <Application/Constants.hpp>
+
+//
+// ────────────────────────────────────────────────────────────────── I ──────────
+//   :::::: S A M P L E   S U M M A R Y : :  :   :    :     :        :          :
+// ────────────────────────────────────────────────────────────────────────────
+//
+// Aggregates of one sample, computed on device by SampleStatistics and kept with the
+// valve that took the sample
+//
+struct SampleSummary {
+    char condition[12]{0};        // What ended the sample: volume, pressure or time
+    unsigned long duration = 0;   // Seconds
+    float pressureMean     = 0;
+    float pressureMin      = 0;
+    float pressureMax      = 0;
+    float pressureVariance = 0;
+    float flowMean         = 0;   // Liters per minute
+    float flowMin          = 0;
+    float flowMax          = 0;
+    float flowVariance     = 0;
+    long timeToPressure    = -1;  // Seconds until the sample pressure was reached, -1 if never
+    float volume           = 0;   // Liters, integrated from the flow rate
+
+    bool isEmpty() const {
+        return condition[0] == 0;
+    }
+
+    void decodeJSON(const JsonVariant & src) {
+        using namespace SampleKeys;
+        strncpy(condition, src[CONDITION] | "", sizeof(condition) - 1);
+        duration         = src[DURATION];
+        pressureMean     = src[PRESSURE_MEAN];
+        pressureMin      = src[PRESSURE_MIN];
+        pressureMax      = src[PRESSURE_MAX];
+        pressureVariance = src[PRESSURE_VARIANCE];
+        flowMean         = src[FLOW_MEAN];
+        flowMin          = src[FLOW_MIN];
+        flowMax          = src[FLOW_MAX];
+        flowVariance     = src[FLOW_VARIANCE];
+        timeToPressure   = src[TIME_TO_PRESSURE] | -1;
+        volume           = src[VOLUME];
+    }
+
+    bool encodeJSON(const JsonVariant & dst) const {
+        using namespace SampleKeys;
+        // clang-format off
+        return dst[CONDITION].set((char *) condition)
+            && dst[DURATION].set(duration)
+            && dst[PRESSURE_MEAN].set(pressureMean)
+            && dst[PRESSURE_MIN].set(pressureMin)
+            && dst[PRESSURE_MAX].set(pressureMax)
+            && dst[PRESSURE_VARIANCE].set(pressureVariance)
+            && dst[FLOW_MEAN].set(flowMean)
+            && dst[FLOW_MIN].set(flowMin)
+            && dst[FLOW_MAX].set(flowMax)
+            && dst[FLOW_VARIANCE].set(flowVariance)
+            && dst[TIME_TO_PRESSURE].set(timeToPressure)
+            && dst[VOLUME].set(volume);
+        // clang-format on
+    }
+};
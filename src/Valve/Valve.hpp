@@ -5,6 +5,7 @@
 #include <Application/Constants.hpp>
 #include <Utilities/JsonEncodableDecodable.hpp>
 #include <Valve/ValveStatus.hpp>
+#include <Valve/SampleSummary.hpp>
 
 //
 // ────────────────────────────────────────────────── I ──────────
@@ -17,6 +18,7 @@ public:
     int id     = ValveStatus::unavailable;
     int status = ValveStatus::unavailable;
     char group[ProgramSettings::VALVE_GROUP_LENGTH]{0};
+    SampleSummary sample;  // Empty until the valve is sampled
 
     Valve()                    = default;
     Valve(const Valve & other) = default;
@@ -41,7 +43,7 @@ public:
     }
 
     static constexpr size_t decodingSize() {
-        return ProgramSettings::VALVE_JSON_BUFFER_SIZE;
+        return ProgramSettings::VALVE_FILE_BUFFER_SIZE;
     }
 
     void decodeJSON(const JsonVariant & src) override {
@@ -53,6 +55,9 @@ public:
         }
 
         status = src[STATUS];
+        if (src.containsKey(SAMPLE)) {
+            sample.decodeJSON(src[SAMPLE]);
+        }
     }
 #pragma endregion
 #pragma region JSONENCODABLE
@@ -69,7 +74,8 @@ public:
         // clang-format off
 		return dst[ID].set(id)
 			   && dst[GROUP].set((char *) group)
-			   && dst[STATUS].set(status);
+			   && dst[STATUS].set(status)
+			   && (sample.isEmpty() || sample.encodeJSON(dst.createNestedObject(SAMPLE)));
 	}  // clang-format on
 
 #pragma endregion
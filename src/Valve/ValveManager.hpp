@@ -52,6 +52,11 @@ public:
         updateObservers(&ValveObserver::valveDidUpdate, valves[id]);
     }
 
+    void setValveSample(int id, const SampleSummary & sample) {
+        valves[id].sample = sample;
+        updateObservers(&ValveObserver::valveDidUpdate, valves[id]);
+    }
+
     /** ────────────────────────────────────────────────────────────────────────────
      *  @brief Set the status of the valve to "free" if the valve is not yet sampled
      *
@@ -87,8 +92,9 @@ public:
      *  corresponding valve object.
      *
      *  @param _dir Path to the valve folder (default=~/valves)
+     *  @param skip Bitmap of the valves to leave as they are (bit i for valve i)
      *  ──────────────────────────────────────────────────────────────────────────── */
-    void loadValvesFromDirectory(const char * _dir = nullptr) {
+    void loadValvesFromDirectory(const char * _dir = nullptr, uint32_t skip = 0) {
         const char * dir = _dir ? _dir : valveFolder;
 
         JsonFileLoader loader;
@@ -96,7 +102,7 @@ public:
 
         auto start = millis();
         for (size_t i = 0; i < valves.size(); i++) {
-            if (valves[i].status != ValveStatus::unavailable) {
+            if (valves[i].status != ValveStatus::unavailable && !(skip >> i & 1)) {
                 KPStringBuilder<32> filename("valve-", i, ".js");
                 KPStringBuilder<64> filepath(dir, "/", filename);
                 loader.load(filepath, valves[i]);
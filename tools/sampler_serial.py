@@ -0,0 +1,222 @@
+"""Host side of the framed binary serial protocol (see src/API/BinarySerial.hpp).
+
+Examples:
+    python tools/sampler_serial.py /dev/ttyACM0 download detail.csv
+    python tools/sampler_serial.py /dev/ttyACM0 command '{"cmd": "status"}'
+
+Downloads are resumable: if the destination file already exists, only the remaining
+bytes are requested. Requires pyserial.
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+
+import serial
+
+PING = 0x01
+FILE_INFO = 0x02
+FILE_READ = 0x03
+COMMAND = 0x04
+EXIT = 0x0F
+
+PONG = 0x81
+FILE_SIZE = 0x82
+FILE_DATA = 0x83
+FILE_END = 0x84
+COMMAND_DATA = 0x85
+COMMAND_END = 0x86
+EXIT_ACK = 0x8F
+ERROR = 0xEE
+
+# Bytes requested per FILE_READ. A lost or corrupted frame only costs this much.
+WINDOW = 16 * 1024
+
+
+def crc16(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_index, distance = 0, 1
+    for byte in data:
+        if byte == 0:
+            out[code_index] = distance
+            code_index, distance = len(out), 1
+            out.append(0)
+            continue
+        out.append(byte)
+        distance += 1
+        if distance == 0xFF:
+            out[code_index] = distance
+            code_index, distance = len(out), 1
+            out.append(0)
+    out[code_index] = distance
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("Malformed COBS frame")
+        out += data[i + 1 : i + code]
+        i += code
+        if code != 0xFF and i != len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class FrameError(Exception):
+    pass
+
+
+class Sampler:
+    def __init__(self, port, timeout=2.0):
+        self.port = serial.Serial(port, 115200, timeout=timeout)
+        self.seq = 0
+
+    def enter_binary_mode(self):
+        self.port.reset_input_buffer()
+        self.port.write(b'{"cmd": "binary"}\n')
+        # Any text still in flight is skipped until the PONG frame shows up
+        for _ in range(10):
+            frame = self.receive()
+            if frame and frame[0] == PONG:
+                return
+        raise FrameError("Device did not enter binary mode")
+
+    def exit_binary_mode(self):
+        self.send(EXIT)
+        self.expect(EXIT_ACK)
+
+    def send(self, frame_type, payload=b""):
+        self.seq = (self.seq + 1) & 0xFFFF
+        frame = struct.pack("<BH", frame_type, self.seq) + payload
+        frame += struct.pack("<H", crc16(frame))
+        self.port.write(b"\0" + cobs_encode(frame) + b"\0")
+        return self.seq
+
+    def receive(self):
+        """Return (type, seq, payload) of the next valid frame or None on timeout."""
+        while True:
+            raw = self.port.read_until(b"\0")
+            if not raw.endswith(b"\0"):
+                return None
+            try:
+                frame = cobs_decode(raw[:-1])
+            except ValueError:
+                continue
+            if len(frame) < 5 or crc16(frame[:-2]) != struct.unpack("<H", frame[-2:])[0]:
+                continue  # Garbage or debug text between frames
+            frame_type, seq = struct.unpack("<BH", frame[:3])
+            return frame_type, seq, frame[3:-2]
+
+    def expect(self, frame_type):
+        frame = self.receive()
+        if frame is None:
+            raise FrameError("Timeout")
+        if frame[0] == ERROR:
+            raise FrameError(frame[2].decode(errors="replace"))
+        if frame[0] != frame_type:
+            raise FrameError("Unexpected frame type 0x%02x" % frame[0])
+        return frame[2]
+
+    def file_size(self, name):
+        self.send(FILE_INFO, name.encode())
+        return struct.unpack("<I", self.expect(FILE_SIZE))[0]
+
+    def read_range(self, name, offset, length, sink):
+        """Write bytes [offset, offset + length) to sink. Returns the offset reached."""
+        seq = self.send(FILE_READ, struct.pack("<II", offset, length) + name.encode())
+        while True:
+            frame = self.receive()
+            if frame is None:
+                return offset
+            frame_type, frame_seq, payload = frame
+            if frame_seq != seq:
+                continue
+            if frame_type == ERROR:
+                raise FrameError(payload.decode(errors="replace"))
+            if frame_type == FILE_END:
+                return offset
+            if frame_type == FILE_DATA:
+                (chunk_offset,) = struct.unpack("<I", payload[:4])
+                if chunk_offset != offset:
+                    # A frame was lost. Drain this request and resume from here.
+                    self.drain(seq)
+                    return offset
+                sink.write(payload[4:])
+                offset += len(payload) - 4
+
+    def drain(self, seq):
+        while True:
+            frame = self.receive()
+            if frame is None or (frame[1] == seq and frame[0] in (FILE_END, ERROR)):
+                return
+
+    def download(self, name, destination):
+        size = self.file_size(name)
+        mode = "ab" if os.path.exists(destination) else "wb"
+        with open(destination, mode) as sink:
+            offset = sink.tell()
+            if offset > size:
+                raise FrameError("Local file is larger than the remote one")
+            while offset < size:
+                offset = self.read_range(name, offset, min(WINDOW, size - offset), sink)
+                sink.flush()
+                print("\r%s: %d / %d bytes" % (name, offset, size), end="", file=sys.stderr)
+        print(file=sys.stderr)
+
+    def command(self, document):
+        seq = self.send(COMMAND, json.dumps(document).encode())
+        body = bytearray()
+        while True:
+            frame = self.receive()
+            if frame is None:
+                raise FrameError("Timeout")
+            frame_type, frame_seq, payload = frame
+            if frame_seq != seq:
+                continue
+            if frame_type == ERROR:
+                raise FrameError(payload.decode(errors="replace"))
+            if frame_type == COMMAND_DATA:
+                body += payload
+            if frame_type == COMMAND_END:
+                return json.loads(body.decode()) if body else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port")
+    sub = parser.add_subparsers(dest="action", required=True)
+    download = sub.add_parser("download", help="Resumable download of a file on the SD card")
+    download.add_argument("name")
+    download.add_argument("destination", nargs="?")
+    command = sub.add_parser("command", help="Send a JSON API command")
+    command.add_argument("json")
+    args = parser.parse_args()
+
+    sampler = Sampler(args.port)
+    sampler.enter_binary_mode()
+    try:
+        if args.action == "download":
+            sampler.download(args.name, args.destination or args.name)
+        else:
+            print(json.dumps(sampler.command(json.loads(args.json)), indent=2))
+    finally:
+        sampler.exit_binary_mode()
+
+
+if __name__ == "__main__":
+    main()